@@ -0,0 +1,496 @@
+/**
+ * Event driven POSIX host driver for the CLI template
+ * 
+ * DEPENDS ON :
+ *  cli_t.h
+ *  POSIX poll(), termios (eventfd on linux, a self pipe elsewhere)
+ * 
+ * Author:    Haerteleric
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Eric Härtel
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+//input is read in bulk from a non-blocking fd, cli_tick() only runs for completed lines (or queued output)
+//the driver sleeps in poll() until input, a wakeup or room for queued output arrives
+//
+//own loop:     while(cli_posixRun(&driver, -1) >= 0);
+//event loop:   watch the fds from cli_posixPollFds() (poll or epoll), call cli_posixDispatch() when one fires,
+//              once at start (prints the prompt after cli_clear()) and after cli_posixTimeout() ms (watch)
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <termios.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+
+#if !defined(_CLI_INCLUDED)
+#error "this template extends cli_t.h include it before this template"
+#endif
+
+#ifndef _CLI_POSIX_INCLUDED
+#define _CLI_POSIX_INCLUDED
+#endif
+
+#ifndef CLI_POSIX_READ_SIZE
+    #define CLI_POSIX_READ_SIZE 64
+#endif
+
+#ifndef CLI_POSIX_RETRY_INTERVAL
+    #define CLI_POSIX_RETRY_INTERVAL 10 //ms, queued output without an outputFd to wait on is retried that often
+#endif
+
+#define CLI_POSIX_NUM_POLL_FDS 3 //wakeup, input, output
+
+#ifndef _CLI_POSIX_DRIVER_STRUCT_DEFINED
+#define _CLI_POSIX_DRIVER_STRUCT_DEFINED
+
+typedef struct cliPosixDriver_s
+{
+    cliInstance_t * instance;
+    int inputFd;                        //set to O_NONBLOCK by cli_posixInit()
+    int outputFd;                       //watched for POLLOUT while output is queued, -1 if printFunction blocks
+
+    //Ignored on init
+    int wakeupFd;                       //eventfd, or the read end of a self pipe
+    int wakeupWriteFd;
+    int savedFlags;                     //file status flags of inputFd before cli_posixInit()
+    bool rawMode;
+    struct termios savedMode;
+    unsigned  int readOffset;           //input read but not consumed yet, held while a line is pending
+    unsigned  int readLength;
+    char readBuffer[CLI_POSIX_READ_SIZE];
+}cliPosixDriver_t;
+
+#endif //_CLI_POSIX_DRIVER_STRUCT_DEFINED
+
+
+#ifndef CLI_ONLY_PROTOTYPE_DECLARATION
+//INTERNAL STATIC SECTION
+//should not be included into Prototype include
+//As such they are always Static
+
+static void posixDrainWakeup(cliPosixDriver_t * driver)
+{
+    char buffer[8]; //eventfd always reads its 8 byte counter
+    while(read(driver->wakeupFd, buffer, sizeof(buffer)) > 0)
+    {
+#ifdef __linux__
+        break; //counter reset by a single read
+#endif
+    }
+}
+
+//a line which can not be executed yet (the output queue is full) blocks further input
+//so does an abort key while idle until cli_tick() dropped the typed line
+static bool posixInputBlocked(cliPosixDriver_t * driver)
+{
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+    if(driver->instance->discardRequested)
+    {
+        return true;
+    }
+#endif
+    return driver->instance->actionPending;
+}
+
+static bool posixOutputQueued(cliPosixDriver_t * driver)
+{
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+    return driver->instance->outputQueueBuffer && driver->instance->outputQueueUsed;
+#else
+    (void) driver;
+    return false;
+#endif
+}
+
+static bool posixOutputPending(cliPosixDriver_t * driver)
+{
+    return (driver->outputFd >= 0) && posixOutputQueued(driver);
+}
+
+#endif// INTERNAL STATIC SECTION
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+int cli_posixInit(cliPosixDriver_t * driver)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+    CLI_ASSERT(driver->instance);
+
+    //returns 0 on success, -1 with errno set otherwise
+    driver->rawMode = false;
+    driver->readOffset = 0;
+    driver->readLength = 0;
+
+    driver->savedFlags = fcntl(driver->inputFd, F_GETFL);
+    if( (driver->savedFlags < 0) || (fcntl(driver->inputFd, F_SETFL, driver->savedFlags | O_NONBLOCK) < 0) )
+    {
+        return -1;
+    }
+
+#ifdef __linux__
+    driver->wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(driver->wakeupFd < 0)
+    {
+        int error = errno;
+        fcntl(driver->inputFd, F_SETFL, driver->savedFlags); //don't leave e.g. the shell's stdin non blocking
+        errno = error;
+        return -1;
+    }
+    driver->wakeupWriteFd = driver->wakeupFd;
+#else
+    int pipeFds[2];
+    if(pipe(pipeFds) < 0)
+    {
+        int error = errno;
+        fcntl(driver->inputFd, F_SETFL, driver->savedFlags); //don't leave e.g. the shell's stdin non blocking
+        errno = error;
+        return -1;
+    }
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        fcntl(pipeFds[i], F_SETFL, fcntl(pipeFds[i], F_GETFL) | O_NONBLOCK);
+        fcntl(pipeFds[i], F_SETFD, FD_CLOEXEC);
+    }
+    driver->wakeupFd = pipeFds[0];
+    driver->wakeupWriteFd = pipeFds[1];
+#endif
+    return 0;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_posixDeinit(cliPosixDriver_t * driver)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+
+    if(driver->rawMode)
+    {
+        tcsetattr(driver->inputFd, TCSANOW, &driver->savedMode);
+        driver->rawMode = false;
+    }
+    //a terminal shares the flags with everyone else using it, e.g. the shell
+    fcntl(driver->inputFd, F_SETFL, driver->savedFlags);
+
+    if(driver->wakeupWriteFd != driver->wakeupFd)
+    {
+        close(driver->wakeupWriteFd);
+    }
+    close(driver->wakeupFd);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+int cli_posixEnableRawMode(cliPosixDriver_t * driver)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+
+    //byte wise input without terminal echo, the cli echoes and edits the line itself
+    //signals and output post processing ("\n" -> "\r\n") stay enabled
+    //restored by cli_posixDeinit(), returns -1 if inputFd is no terminal
+    //the terminal no longer echoes, so the instance usually wants localEcho set on success
+    struct termios mode;
+    if(tcgetattr(driver->inputFd, &mode) < 0)
+    {
+        return -1;
+    }
+    if(!driver->rawMode)
+    {
+        driver->savedMode = mode;
+    }
+
+    mode.c_iflag &= ~(ICRNL | INLCR | IGNCR | IXON | ISTRIP);
+    mode.c_lflag &= ~(ICANON | ECHO | ECHONL | IEXTEN);
+    mode.c_cc[VMIN] = 1;
+    mode.c_cc[VTIME] = 0;
+    if(tcsetattr(driver->inputFd, TCSANOW, &mode) < 0)
+    {
+        return -1;
+    }
+
+    driver->rawMode = true;
+    return 0;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_posixWakeup(cliPosixDriver_t * driver)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+
+    //async signal and thread safe, makes the driver tick the instance once
+    //e.g. after actionPending or queued output got changed from elsewhere
+#ifdef __linux__
+    unsigned long long increment = 1;
+    ssize_t written = write(driver->wakeupWriteFd, &increment, sizeof(increment));
+#else
+    ssize_t written = write(driver->wakeupWriteFd, "", 1); //a full pipe already wakes up
+#endif
+    (void) written;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+unsigned int cli_posixPollFds(cliPosixDriver_t * driver, struct pollfd fds[CLI_POSIX_NUM_POLL_FDS])
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+    CLI_ASSERT(fds);
+
+    //fds to wait for before the next cli_posixDispatch(), returns the number used
+    //input is only watched while a new line can be taken, queued output adds POLLOUT
+    unsigned int numFds = 0;
+
+    fds[numFds].fd = driver->wakeupFd;
+    fds[numFds].events = POLLIN;
+    fds[numFds++].revents = 0;
+
+    if(!posixInputBlocked(driver))
+    {
+        fds[numFds].fd = driver->inputFd;
+        fds[numFds].events = POLLIN;
+        fds[numFds++].revents = 0;
+    }
+
+    if(posixOutputPending(driver))
+    {
+        if( (numFds > 1) && (driver->outputFd == driver->inputFd) )
+        {
+            fds[numFds - 1].events |= POLLOUT;
+        }
+        else
+        {
+            fds[numFds].fd = driver->outputFd;
+            fds[numFds].events = POLLOUT;
+            fds[numFds++].revents = 0;
+        }
+    }
+
+    return numFds;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+int cli_posixTimeout(cliPosixDriver_t * driver)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+
+    //ms until cli_posixDispatch() is due without any fd event, -1 if only events matter
+    int timeout = -1;
+
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+    //the typed line gets dropped before any output is looked at
+    if(driver->instance->discardRequested)
+    {
+        return 0;
+    }
+#endif
+
+    if(posixOutputQueued(driver))
+    {
+        //a pending line waits for the queue to drain: POLLOUT on outputFd, or a retry of printFunction
+        if(driver->outputFd < 0)
+        {
+            timeout = CLI_POSIX_RETRY_INTERVAL;
+        }
+    }
+    else if(driver->instance->actionPending)
+    {
+        return 0; //the line can run right away (e.g. the prompt after cli_clear())
+    }
+
+#ifdef CLI_ENABLE_WATCH
+    //next run of the watched command
+    cliInstance_t * instance = driver->instance;
+    if(instance->watchCommand)
+    {
+        unsigned int elapsed = instance->timeFunction() - instance->watchTimestamp;
+        int due = (elapsed < instance->watchInterval ? (int) (instance->watchInterval - elapsed) : 0);
+        timeout = ( (timeout < 0) || (due < timeout) ? due : timeout );
+    }
+#endif
+
+    return timeout;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+int cli_posixDispatch(cliPosixDriver_t * driver)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+
+    //takes all available input, executes the completed lines and flushes queued output
+    //never blocks, returns 0 or -1 once the input reached end of file (or failed)
+    cliInstance_t * instance = driver->instance;
+
+    posixDrainWakeup(driver);
+
+    for (;;)
+    {
+        //completed line (or the prompt after cli_clear()), stays pending while the output queue is full
+        if(posixInputBlocked(driver))
+        {
+            cli_tick(instance);
+            if(posixInputBlocked(driver))
+            {
+                return 0; //continue on POLLOUT
+            }
+        }
+
+        if(driver->readOffset == driver->readLength)
+        {
+            ssize_t received = read(driver->inputFd, driver->readBuffer, sizeof(driver->readBuffer));
+            if(received <= 0)
+            {
+                if( (received < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) )
+                {
+                    break; //all input taken
+                }
+                return -1;
+            }
+            driver->readOffset = 0;
+            driver->readLength = received;
+        }
+
+        driver->readOffset += cli_inputChars(
+            instance,
+            &driver->readBuffer[driver->readOffset],
+            driver->readLength - driver->readOffset
+        );
+    }
+
+#ifdef CLI_ENABLE_WATCH
+    if(instance->watchCommand)
+    {
+        cli_tick(instance); //reruns the watched command once it is due
+    }
+#endif
+
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+    cli_flushOutput(instance);
+#endif
+    return 0;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+int cli_posixRun(cliPosixDriver_t * driver, int timeoutMs)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(driver);
+
+    //sleeps until there is something to do (at most timeoutMs, -1 forever) and does it
+    //returns the number of ready fds (0 on timeout) or -1 once the input is closed
+    struct pollfd fds[CLI_POSIX_NUM_POLL_FDS];
+    unsigned int numFds = cli_posixPollFds(driver, fds);
+
+    int due = cli_posixTimeout(driver);
+    if( (due >= 0) && ((timeoutMs < 0) || (due < timeoutMs)) )
+    {
+        timeoutMs = due;
+    }
+
+    int ready = poll(fds, numFds, timeoutMs);
+    if( (ready < 0) && (errno != EINTR) )
+    {
+        return -1;
+    }
+
+    if(cli_posixDispatch(driver) < 0)
+    {
+        return -1;
+    }
+    return (ready > 0 ? ready : 0);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
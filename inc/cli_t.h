@@ -32,6 +32,9 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <string.h>
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+#include <stdint.h>
+#endif
 
 
 #if (!defined(_ASCII_PARSER_INCLUDED) || !defined(_ASCII_PRINTER_INCLUDED)) && !defined(CLI_ONLY_PROTOTYPE_DECLARATION)
@@ -46,8 +49,85 @@
     #define CLI_ASSERT(...) //stub
 #endif
 
+#if defined(CLI_ENABLE_HISTORY) && !defined(CLI_ENABLE_LINE_EDITOR)
+#error "CLI_ENABLE_HISTORY depends on CLI_ENABLE_LINE_EDITOR"
+#endif
+
+#if defined(CLI_IMPLEMENT_WATCH_COMMAND) && !defined(CLI_ENABLE_WATCH)
+#error "CLI_IMPLEMENT_WATCH_COMMAND depends on CLI_ENABLE_WATCH"
+#endif
+
+#if defined(CLI_IMPLEMENT_MACRO_COMMAND) && !defined(CLI_ENABLE_MACROS)
+#error "CLI_IMPLEMENT_MACRO_COMMAND depends on CLI_ENABLE_MACROS"
+#endif
+
+#ifndef CLI_MACRO_MAX_NESTING
+    #define CLI_MACRO_MAX_NESTING 4
+#endif
+
+#ifndef CLI_HISTORY_SEARCH_PATTERN_SIZE
+    #define CLI_HISTORY_SEARCH_PATTERN_SIZE 32
+#endif
+
+#ifndef CLI_OUTPUT_CACHE_SLOT_SIZE
+    #define CLI_OUTPUT_CACHE_SLOT_SIZE 256
+#endif
+
+#define CLI_OUTPUT_CACHE_UNTIL_INVALIDATED ((unsigned int) -1)
+
+#ifndef CLI_SCRATCH_ALIGNMENT
+    #define CLI_SCRATCH_ALIGNMENT sizeof(void *)
+#endif
+
+//session recording: header followed by records of
+//direction (CLI_RECORD_INPUT / CLI_RECORD_OUTPUT), varint ms since the previous record, varint length, data
+#define CLI_RECORD_MAGIC        "cliR\x01"
+#define CLI_RECORD_MAGIC_SIZE   5
+#define CLI_RECORD_INPUT        'I'
+#define CLI_RECORD_OUTPUT       'O'
+
+//features which need to redirect the handler output into a buffer
+#if defined(CLI_ENABLE_OUTPUT_CACHE) || defined(CLI_ENABLE_WATCH)
+    #define _CLI_OUTPUT_CAPTURE
+#endif
+
 typedef unsigned int (* cliPrint_func)(const char * buffer, unsigned  int len);
 typedef void (* cliExec_func)(int argc, char const *argv[], cliPrint_func outputFunc);
+typedef unsigned int (* cliTime_func)(void); //free running millisecond counter
+
+struct cliInstance_s;
+//extended handler, gets the executing instance and returns a status (CLI_STATUS_SUCCESS or an error code)
+typedef int (* cliExecEx_func)(struct cliInstance_s * instance, int argc, char const *argv[], cliPrint_func outputFunc);
+
+#define CLI_STATUS_SUCCESS          0
+#define CLI_STATUS_FAILURE          1
+#define CLI_STATUS_UNKNOWN_COMMAND  127
+
+#if defined(CLI_ENABLE_STRUCTURED_OUTPUT) && !defined(_CLI_OUTPUT_FORMAT_ENUM_DEFINED)
+#define _CLI_OUTPUT_FORMAT_ENUM_DEFINED
+
+//rendering of the cli_emit...() calls
+typedef enum cliOutputFormat_e
+{
+    CLI_OUTPUT_TEXT,    //indented "key: value" lines for humans
+    CLI_OUTPUT_JSON,    //one JSON document per line
+    CLI_OUTPUT_TLV      //tag, varint length, value
+}cliOutputFormat_t;
+
+//TLV tags, containers are streamed as begin / end marker with length 0
+#define CLI_TLV_OBJECT_BEGIN    0x01
+#define CLI_TLV_OBJECT_END      0x02
+#define CLI_TLV_ARRAY_BEGIN     0x03
+#define CLI_TLV_ARRAY_END       0x04
+#define CLI_TLV_KEY             0x05
+#define CLI_TLV_INT             0x06    //zigzag varint
+#define CLI_TLV_UNSIGNED        0x07    //varint
+#define CLI_TLV_STRING          0x08
+#define CLI_TLV_BYTES           0x09
+#define CLI_TLV_BOOL            0x0A
+#define CLI_TLV_FLOAT           0x0B    //IEEE 754 binary32, little endian
+
+#endif //_CLI_OUTPUT_FORMAT_ENUM_DEFINED
 
 #ifndef _CLI_ENTRY_STRUCT_DEFINED
 #define _CLI_ENTRY_STRUCT_DEFINED
@@ -61,11 +141,81 @@ typedef struct cliEntry_s
     //Ignored on init
     //Don't mess with this after calling cli_addCommand()
     struct cliEntry_s * next;
+
+    //Ignored on init
+    //Child commands of this entry (e.g. "net" -> "if" -> "stats"), filled by cli_addSubCommand()
+    //An entry with children but without execFunction acts as a pure command group
+    struct cliEntry_s * subCommandLinkedListRoot;
+
+    //Optional alternative to execFunction with access to the instance and a return status, only one of them should be set
+    const cliExecEx_func execFunctionEx;
+
+#ifdef CLI_ENABLE_OUTPUT_CACHE
+    //Optional, marks an idempotent command whose output may be replayed for the same arguments
+    //0 = never cached, otherwise the validity in ms (not cached on an instance without timeFunction)
+    //or CLI_OUTPUT_CACHE_UNTIL_INVALIDATED to keep it until cli_invalidateOutputCache()
+    unsigned int outputCacheTimeToLive;
+#endif
 }cliEntry_t;
 
 #endif //_CLI_ENTRY_STRUCT_DEFINED
 
 
+#if defined(CLI_ENABLE_PRIORITY_COMMANDS) && !defined(_CLI_PRIORITY_ENTRY_STRUCT_DEFINED)
+#define _CLI_PRIORITY_ENTRY_STRUCT_DEFINED
+
+//runs right in the input path, possibly in interrupt context: keep it short
+typedef void (* cliPriority_func)(struct cliInstance_s * instance);
+
+//key handled before any other input processing, even while a line is pending or executing
+typedef struct cliPriorityEntry_s
+{
+    char key;                       //a control character, e.g. '\x03' (Ctrl-C)
+    bool abort;                     //drops the pending line and raises cli_abortRequested() for the running command
+    cliPriority_func function;      //optional
+
+    //Ignored on init
+    volatile unsigned int hits;     //counted on every occurrence, usable as a flag by the application
+}cliPriorityEntry_t;
+
+#endif //_CLI_PRIORITY_ENTRY_STRUCT_DEFINED
+
+
+#if defined(CLI_ENABLE_OUTPUT_CACHE) && !defined(_CLI_OUTPUT_CACHE_SLOT_STRUCT_DEFINED)
+#define _CLI_OUTPUT_CACHE_SLOT_STRUCT_DEFINED
+
+typedef struct cliOutputCacheSlot_s
+{
+    //Ignored on init
+    const cliEntry_t * command;     //NULL marks an empty slot
+    unsigned int keyHash;
+    unsigned int keyLength;
+    unsigned int outputLength;
+    unsigned int timestamp;
+    unsigned int epoch;
+    char data[CLI_OUTPUT_CACHE_SLOT_SIZE]; //arguments ('\0' separated) followed by the rendered output
+}cliOutputCacheSlot_t;
+
+#endif //_CLI_OUTPUT_CACHE_SLOT_STRUCT_DEFINED
+
+
+#ifndef _CLI_PREFIX_NODE_STRUCT_DEFINED
+#define _CLI_PREFIX_NODE_STRUCT_DEFINED
+
+//Node of the prefix index (left-child right-sibling trie over the command names)
+//the levels of the command tree are chained by a ' ' node below the end of the parent name
+typedef struct cliPrefixNode_s
+{
+    struct cliPrefixNode_s * child;     //first node of the following character
+    struct cliPrefixNode_s * sibling;   //next alternative for the same character position
+    cliEntry_t * command;               //entry whose name ends on this node
+    unsigned short numCommands;         //number of names of this level passing this node
+    char key;
+}cliPrefixNode_t;
+
+#endif //_CLI_PREFIX_NODE_STRUCT_DEFINED
+
+
 #ifndef _CLI_INSTANCE_STRUCT_DEFINED
 #define _CLI_INSTANCE_STRUCT_DEFINED
 
@@ -82,10 +232,192 @@ typedef struct cliInstance_s
 
     cliPrint_func printFunction;
     cliEntry_t *commandLinkedListRoot;
+
+    //Optional millisecond clock for everything time based (cache expiry, timers)
+    cliTime_func timeFunction;
+
+    //Ignored on init
+    int lastStatus; //status of the last executed command
+
+    //Ignored on init
+    //progress through the pending line, cli_tickLimited() may split it over several ticks
+    unsigned  int dispatchOffset;
+    bool dispatchStarted;
+    bool dispatchSkip;                  //previous command failed before "&&"
+    bool dispatchEchoed;
+
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+    //Optional ring for output printFunction did not accept right away
+    //printFunction has to return the number of bytes it accepted, the rest gets retried on later ticks
+    //cli_inputChar() & cli_tick() must not preempt each other while output is queued
+    char *outputQueueBuffer;
+    unsigned  int outputQueueSize;
+
+    //Ignored on init
+    unsigned  int outputQueueHead;
+    unsigned  int outputQueueUsed;
+    unsigned  int outputDroppedBytes;   //output lost because the queue ran full
+#endif
+
+#ifdef CLI_ENABLE_OUTPUT_CACHE
+    //Optional slots for replaying the output of commands with outputCacheTimeToLive set
+    cliOutputCacheSlot_t *outputCacheSlots;
+    unsigned  int outputCacheNumSlots;
+
+    //Ignored on init
+    unsigned  int outputCacheEpoch;         //bumped by cli_invalidateOutputCache()
+    unsigned  int outputCacheNextSlot;      //round robin replacement
+#endif
+
+#ifdef CLI_ENABLE_SCRATCH_ARENA
+    //Optional scratch memory for the command handlers, see cli_scratchAlloc()
+    //everything allocated is released once the command returns
+    unsigned char *scratchArena;
+    unsigned  int scratchArenaSize;
+
+    //Ignored on init
+    unsigned  int scratchArenaUsed;
+#endif
+
+#ifdef _CLI_OUTPUT_CAPTURE
+    //Ignored on init
+    //handler output is copied here while captureBuffer is set
+    char *captureBuffer;
+    unsigned  int captureSize;
+    unsigned  int captureLength;
+    bool captureOverflow;
+    bool capturePassthrough;            //still send the output on
+#endif
+
+#ifdef CLI_ENABLE_WATCH
+    //Optional storage for cli_watch(): the arguments, then the output of the previous and of the current run
+    //the output of a single run has to fit into half of the space behind the arguments
+    char *watchBuffer;
+    unsigned  int watchBufferSize;
+
+    //Ignored on init
+    cliEntry_t * watchCommand;          //NULL while not watching
+    unsigned  int watchInterval;
+    unsigned  int watchTimestamp;
+    unsigned  int watchArgc;
+    unsigned  int watchArgumentsLength;
+    unsigned  int watchOutputLength;    //output of the previous run
+    unsigned  int watchLines;           //rows of the previous run on the screen
+    bool watchSwap;                     //the halves of the output storage changed roles
+#endif
+
+#ifdef CLI_ENABLE_MACROS
+    //Optional storage for cli_macroDefine(), keeps the commands resolved and their arguments split
+    unsigned char *macroArena;
+    unsigned  int macroArenaSize;
+
+    //Ignored on init
+    unsigned  int macroArenaUsed;
+    unsigned char macroNesting;         //macros running right now
+#endif
+
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+    //Optional table of keys handled out of band, see cli_priorityInput()
+    cliPriorityEntry_t *priorityCommands;
+    unsigned  int numPriorityCommands;
+
+    //Ignored on init
+    volatile bool abortRequested;       //set until the next line starts
+    volatile bool discardRequested;     //abort key while idle, the next tick drops the typed line
+#endif
+
+#ifdef CLI_ENABLE_LINE_EDITOR
+    //Ignored on init
+    unsigned  int cursorPosition;
+    unsigned char escapeState;
+    unsigned char escapeParameter;
+#endif
+
+#ifdef CLI_ENABLE_HISTORY
+    //Optional ring storage for previous lines (needs CLI_ENABLE_LINE_EDITOR)
+    //lines are kept '\0' separated, the oldest ones are dropped as a whole when it runs full
+    char *historyBuffer;
+    unsigned  int historyBufferSize;
+
+    //Ignored on init
+    unsigned  int historyHead;          //next write position
+    unsigned  int historyUsed;          //bytes in use
+    unsigned  int historyRecall;        //distance from head back to the recalled line start, 0 on a new line
+    bool historySearching;              //Ctrl-R incremental reverse search active, the edited line is kept until it is over
+    unsigned  int historySearchCursor;  //cursor of the edited line, restored by Ctrl-G
+    unsigned char historySearchLength;
+    char historySearchPattern[CLI_HISTORY_SEARCH_PATTERN_SIZE];
+#endif
+
+#ifdef CLI_ENABLE_RECORDING
+    //Ignored on init
+    //set by cli_startRecording(), receives the input and everything handed on to printFunction
+    cliPrint_func recordFunction;
+    unsigned  int recordTimestamp;      //timeFunction() of the previous record
+#endif
+
+#ifdef CLI_ENABLE_STRUCTURED_OUTPUT
+    //rendering of the cli_emit...() calls, change at runtime with cli_setOutputFormat()
+    cliOutputFormat_t outputFormat;
+
+    //Ignored on init
+    unsigned  int emitSiblingMask;      //bit n: level n already has an element
+    unsigned char emitDepth;
+    bool emitAfterKey;
+#endif
+
+    //Optional storage for the prefix index used for abbreviations and tab completion
+    //NULL falls back to a linear search of each command tree level
+    //needs roughly one node per character of all command names
+    cliPrefixNode_t *prefixIndexPool;
+    unsigned  int prefixIndexPoolSize;
+
+    //Ignored on init
+    //rebuilt on demand whenever the command tree changed
+    unsigned  int prefixIndexPoolUsed;
+    unsigned  int prefixIndexGeneration;
 }cliInstance_t;
 
 #endif //_CLI_INSTANCE_STRUCT_DEFINED
 
+
+#if defined(CLI_ENABLE_SCHEDULER) && !defined(_CLI_SCHEDULER_STRUCT_DEFINED)
+#define _CLI_SCHEDULER_STRUCT_DEFINED
+
+//instance served by a cliScheduler_t
+typedef struct cliSchedulerSlot_s
+{
+    cliInstance_t * instance;
+    unsigned int commandBudget;         //max commands of this instance per cli_schedulerTick(), 0 = no own limit
+
+    //Ignored on init
+    //metrics, may be reset by the application at any time
+    unsigned int executedCommands;      //commands run for this instance
+    unsigned int deferredTicks;         //ticks which ended with commands of this instance left over
+    unsigned int pendingCommands;       //queue depth after the last tick, see cli_pendingCommands()
+    unsigned int maxPendingCommands;
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+    unsigned int maxQueuedOutput;       //highest outputQueueUsed seen after a tick
+#endif
+    unsigned int tickCommands;          //commands run in the current tick
+}cliSchedulerSlot_t;
+
+//services several instances round robin, one command per turn
+typedef struct cliScheduler_s
+{
+    cliSchedulerSlot_t * slots;
+    unsigned int numSlots;              //up to 32
+    unsigned int commandBudget;         //max commands over all instances per cli_schedulerTick(), 0 = unlimited
+    unsigned int timeBudget;            //ms per cli_schedulerTick(), checked between commands, 0 = unlimited
+    cliTime_func timeFunction;          //needed for timeBudget
+
+    //Ignored on init
+    unsigned int readySet;              //bit n: slot n has a command left, updated by cli_schedulerTick()
+    unsigned int nextSlot;              //slot served first on the next tick
+}cliScheduler_t;
+
+#endif //_CLI_SCHEDULER_STRUCT_DEFINED
+
 #ifndef _CLI_ARG_TYPE_ENUM_DEFINED
 #define _CLI_ARG_TYPE_ENUM_DEFINED
 
@@ -96,6 +428,9 @@ typedef enum cliArgumentType_e
     CLI_ARGUMENT_BINARY_LITERAL,
     CLI_ARGUMENT_HEX_LITERAL,
     CLI_ARGUMENT_BYTE_ARRAY,
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+    CLI_ARGUMENT_FLOAT,
+#endif
     CLI_ARGUMENT_UNDEFINED
 
 }cliArgumentType_t;
@@ -214,7 +549,4174 @@ static unsigned int getElementsByteArray(const char * str, unsigned char * buffe
     return numElemets;
 }
 
-#endif// INTERNAL STATIC SECTION
+//LEB128, returns the number of bytes used (at most 5)
+inline static unsigned int putVarint(unsigned char * buffer, unsigned int value)
+{
+    unsigned int length = 0;
+    do
+    {
+        buffer[length] = value & 0x7F;
+        value >>= 7;
+        buffer[length++] |= (value ? 0x80 : 0);
+    } while(value);
+    return length;
+}
+
+//bumped on every change of the command tree, invalidates the prefix index of all instances
+static unsigned int s_cliCommandTreeGeneration = 1;
+
+static void linkedListAppend(cliEntry_t ** root, cliEntry_t * command)
+{
+    cliEntry_t * lastCommand = *root;
+
+    if(lastCommand == NULL)
+    {
+        *root = command;
+    }
+    else
+    {
+        //find last command of linked List
+        while ( ( lastCommand->next != lastCommand ) && (lastCommand->next != NULL) )
+        {
+            lastCommand = lastCommand->next;
+        }
+        //Append command to linked List
+        lastCommand->next = command;
+    }
+
+    //mark command as new end of linked List
+    command->next = command;
+
+    s_cliCommandTreeGeneration++;
+}
+
+static void linkedListRemove(cliEntry_t ** root, cliEntry_t * command)
+{
+    //check if there is something to remove
+    if(*root == NULL)
+    {
+        return;
+    }
+
+    //check if the command to be removed is the current root command
+    if (*root == command)
+    {
+        //check if command is the only command in linked List
+        if(command->next == command)
+        {
+            //mark list as empty
+            *root = NULL;
+        }
+        else
+        {
+            //make the next command the new root command
+            *root = command->next;
+        }
+    }
+    else
+    {
+        //find previous Entry in Linked List
+        cliEntry_t * previousEntry = *root;
+        while ( previousEntry->next != command)
+        {
+            previousEntry = previousEntry->next;
+        }
+
+        //remove command from linked List, keep the end marker if command was the last one
+        previousEntry->next = (command->next == command ? previousEntry : command->next);
+    }
+
+    //Mark Command as not at part of a linked List
+    command->next = NULL;
+
+    s_cliCommandTreeGeneration++;
+}
+
+//Output path
+//every output of the cli (echo, prompt and the handlers) goes through here
+
+//instance whose command is currently executed, target of handlerOutput()
+//shared by all instances: those with queued, captured or recorded output must not be ticked concurrently
+static cliInstance_t * s_cliActiveInstance = NULL;
+
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+//hands queued output to printFunction as far as it accepts it, returns the bytes still queued
+static unsigned int flushOutput(cliInstance_t * instance)
+{
+    while(instance->outputQueueUsed)
+    {
+        unsigned int tail = (instance->outputQueueHead + instance->outputQueueSize - instance->outputQueueUsed) % instance->outputQueueSize;
+        unsigned int chunk = instance->outputQueueSize - tail;
+        chunk = (instance->outputQueueUsed < chunk ? instance->outputQueueUsed : chunk);
+
+        unsigned int accepted = instance->printFunction(&instance->outputQueueBuffer[tail], chunk);
+        accepted = (accepted < chunk ? accepted : chunk);
+        instance->outputQueueUsed -= accepted;
+
+        if(accepted < chunk)
+        {
+            break; //consumer is busy, retry later
+        }
+    }
+    return instance->outputQueueUsed;
+}
+#endif
+
+#ifdef CLI_ENABLE_RECORDING
+static void recordData(cliInstance_t * instance, char direction, const char * data, unsigned int length)
+{
+    if( (instance->recordFunction == NULL) || (length == 0) )
+    {
+        return;
+    }
+
+    unsigned int now = (instance->timeFunction ? instance->timeFunction() : 0);
+    unsigned char header[1 + 5 + 5];
+    unsigned int headerLength = 0;
+
+    header[headerLength++] = direction;
+    headerLength += putVarint(&header[headerLength], now - instance->recordTimestamp);
+    headerLength += putVarint(&header[headerLength], length);
+    instance->recordTimestamp = now;
+
+    instance->recordFunction((const char *) header, headerLength);
+    instance->recordFunction(data, length);
+}
+#endif
+
+//returns the number of bytes accepted (sent or queued)
+static unsigned int printOutput(cliInstance_t * instance, const char * buffer, unsigned int len)
+{
+#ifdef _CLI_OUTPUT_CAPTURE
+    if(instance->captureBuffer)
+    {
+        //truncated at the first output that does not fit
+        if(instance->captureOverflow || (len > (instance->captureSize - instance->captureLength)))
+        {
+            instance->captureOverflow = true;
+        }
+        else
+        {
+            memcpy(&instance->captureBuffer[instance->captureLength], buffer, len);
+            instance->captureLength += len;
+        }
+
+        if(!instance->capturePassthrough)
+        {
+            return len;
+        }
+    }
+#endif
+
+#ifdef CLI_ENABLE_RECORDING
+    recordData(instance, CLI_RECORD_OUTPUT, buffer, len);
+#endif
+
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+    if(instance->outputQueueBuffer && instance->outputQueueSize)
+    {
+        unsigned int accepted = 0;
+
+        //keep the order, nothing bypasses queued output
+        if( (instance->outputQueueUsed == 0) && len )
+        {
+            accepted = instance->printFunction(buffer, len);
+            accepted = (accepted < len ? accepted : len);
+        }
+
+        unsigned int space = instance->outputQueueSize - instance->outputQueueUsed;
+        unsigned int queued = len - accepted;
+        if(queued > space)
+        {
+            instance->outputDroppedBytes += queued - space;
+            queued = space;
+        }
+
+        for (unsigned int i = 0; i < queued; i++)
+        {
+            instance->outputQueueBuffer[instance->outputQueueHead] = buffer[accepted + i];
+            instance->outputQueueHead = (instance->outputQueueHead + 1) % instance->outputQueueSize;
+        }
+        instance->outputQueueUsed += queued;
+
+        return accepted + queued;
+    }
+#endif
+
+    instance->printFunction(buffer, len);
+    return len;
+}
+
+//routes the output of a handler into the instance executing it
+static unsigned int handlerOutput(const char * buffer, unsigned int len)
+{
+    if(s_cliActiveInstance == NULL)
+    {
+        return 0; //stored by a handler and called after its command, there is no instance to print to
+    }
+    return printOutput(s_cliActiveInstance, buffer, len);
+}
+
+//cliPrint_func handed to the command handlers
+//printFunction itself as long as nothing has to be intercepted, then the instances stay independent
+//of each other (e.g. ticked from different threads or interrupts) like without the output path
+static cliPrint_func handlerOutputFor(cliInstance_t * instance)
+{
+#ifdef _CLI_OUTPUT_CAPTURE
+    if(instance->captureBuffer)
+    {
+        return handlerOutput;
+    }
+#endif
+#ifdef CLI_ENABLE_RECORDING
+    if(instance->recordFunction)
+    {
+        return handlerOutput;
+    }
+#endif
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+    if(instance->outputQueueBuffer && instance->outputQueueSize)
+    {
+        return handlerOutput;
+    }
+#endif
+    return instance->printFunction;
+}
+
+//searches a single level of the command tree
+//an exact name match wins, otherwise an unambiguous abbreviation is accepted
+static cliEntry_t * findCommand(cliEntry_t * root, const char * name, unsigned int length)
+{
+    cliEntry_t * candidate = NULL;
+    unsigned int numCandidates = 0;
+
+    cliEntry_t * command = root;
+    while(command)
+    {
+        if(strncmp(name, command->commandCallName, length) == 0)
+        {
+            if(command->commandCallName[length] == '\0')
+            {
+                return command;
+            }
+            candidate = command;
+            numCandidates++;
+        }
+
+        //Go to next Command in list
+        command = (command->next != command ? command->next : NULL);
+    }
+    return (numCandidates == 1 ? candidate : NULL);
+}
+
+static cliPrefixNode_t * prefixIndexChild(cliPrefixNode_t * node, char key)
+{
+    cliPrefixNode_t * child = node->child;
+    while(child && (child->key != key))
+    {
+        child = child->sibling;
+    }
+    return child;
+}
+
+static cliPrefixNode_t * prefixIndexAddChild(cliInstance_t * instance, cliPrefixNode_t * node, char key)
+{
+    cliPrefixNode_t * child = prefixIndexChild(node, key);
+    if(child == NULL)
+    {
+        if(instance->prefixIndexPoolUsed >= instance->prefixIndexPoolSize)
+        {
+            return NULL; //pool exhausted
+        }
+        child = &instance->prefixIndexPool[instance->prefixIndexPoolUsed++];
+        child->child = NULL;
+        child->command = NULL;
+        child->numCommands = 0;
+        child->key = key;
+        child->sibling = node->child;
+        node->child = child;
+    }
+    return child;
+}
+
+static bool prefixIndexInsertLevel(cliInstance_t * instance, cliPrefixNode_t * levelRoot, cliEntry_t * root)
+{
+    cliEntry_t * command = root;
+    while(command)
+    {
+        cliPrefixNode_t * node = levelRoot;
+        for (const char * c = command->commandCallName; *c; c++)
+        {
+            node = prefixIndexAddChild(instance, node, *c);
+            if(node == NULL)
+            {
+                return false;
+            }
+            node->numCommands++;
+        }
+
+        //first entry wins on duplicate names, just like findCommand()
+        if(node->command == NULL)
+        {
+            node->command = command;
+        }
+
+        if(command->subCommandLinkedListRoot)
+        {
+            cliPrefixNode_t * subLevelRoot = prefixIndexAddChild(instance, node, ' ');
+            if( (subLevelRoot == NULL) || !prefixIndexInsertLevel(instance, subLevelRoot, command->subCommandLinkedListRoot) )
+            {
+                return false;
+            }
+        }
+
+        //Go to next Command in list
+        command = (command->next != command ? command->next : NULL);
+    }
+    return true;
+}
+
+//returns the root of the top level index, or NULL if no (usable) index is configured
+static cliPrefixNode_t * prefixIndexGet(cliInstance_t * instance)
+{
+    if( (instance->prefixIndexPool == NULL) || (instance->prefixIndexPoolSize == 0) )
+    {
+        return NULL;
+    }
+
+    if(instance->prefixIndexGeneration != s_cliCommandTreeGeneration)
+    {
+        instance->prefixIndexGeneration = s_cliCommandTreeGeneration;
+
+        cliPrefixNode_t * root = &instance->prefixIndexPool[0];
+        root->child = NULL;
+        root->sibling = NULL;
+        root->command = NULL;
+        root->numCommands = 0;
+        root->key = '\0';
+        instance->prefixIndexPoolUsed = 1;
+
+        if(!prefixIndexInsertLevel(instance, root, instance->commandLinkedListRoot))
+        {
+            //pool too small, stay on the linear search until the tree changes again
+            instance->prefixIndexPoolUsed = 0;
+        }
+    }
+
+    return (instance->prefixIndexPoolUsed ? &instance->prefixIndexPool[0] : NULL);
+}
+
+//walks name down one level of the index, node receives the last node reached (NULL if none)
+//an exact name match wins, otherwise an unambiguous abbreviation is followed to its entry
+//' ' separates the levels in the index, a name containing one (a quoted argument) matches nothing
+static cliEntry_t * prefixIndexFind(cliPrefixNode_t * levelRoot, const char * name, unsigned int length, cliPrefixNode_t ** node)
+{
+    cliPrefixNode_t * current = levelRoot;
+    for (unsigned int i = 0; (i < length) && current; i++)
+    {
+        current = (name[i] != ' ' ? prefixIndexChild(current, name[i]) : NULL);
+    }
+
+    *node = current;
+    if( (current == NULL) || ((current->command == NULL) && (current->numCommands != 1)) )
+    {
+        return NULL;
+    }
+
+    //unique abbreviation, there is exactly one path down to the name end
+    while(current->command == NULL)
+    {
+        current = current->child;
+    }
+    *node = current;
+    return current->command;
+}
+
+//descends the command tree one argument per level
+//returns the deepest matching entry, depth receives the number of arguments consumed by the path
+//the prefix index is optional (NULL), each level is then searched linearly
+static cliEntry_t * resolveCommand(cliPrefixNode_t * index, cliEntry_t * root, unsigned int numArguments, char ** argumentsVector, unsigned int * depth)
+{
+    cliEntry_t * command = NULL;
+    cliEntry_t * level = root;
+    unsigned int i = 0;
+
+    while( (i < numArguments) && level )
+    {
+        cliEntry_t * child;
+        if(index)
+        {
+            cliPrefixNode_t * node;
+            child = prefixIndexFind(index, argumentsVector[i], strlen(argumentsVector[i]), &node);
+            index = (child ? prefixIndexChild(node, ' ') : NULL);
+        }
+        else
+        {
+            child = findCommand(level, argumentsVector[i], strlen(argumentsVector[i]));
+        }
+
+        if(child == NULL)
+        {
+            break;
+        }
+        command = child;
+        level = child->subCommandLinkedListRoot;
+        i++;
+    }
+
+    *depth = i;
+    return command;
+}
+
+//prints all names of one index level below node
+static void prefixIndexList(cliInstance_t * instance, cliPrefixNode_t * node)
+{
+    if(node->command)
+    {
+        printOutput(instance, node->command->commandCallName, strlen(node->command->commandCallName));
+        printOutput(instance, "  ", 2);
+    }
+
+    for (cliPrefixNode_t * child = node->child; child; child = child->sibling)
+    {
+        //' ' leads to the next level of the command tree
+        if(child->key != ' ')
+        {
+            prefixIndexList(instance, child);
+        }
+    }
+}
+
+//tab completion of the command path at the end of the input buffer
+//a unique or shared continuation is appended and only those characters are sent,
+//otherwise the candidates get listed and the line is printed again
+static void completeInput(cliInstance_t * instance)
+{
+    char * buffer = instance->inputBuffer;
+    unsigned int length = instance->inputBufferFilledSize;
+
+    cliPrefixNode_t * index = prefixIndexGet(instance);
+    cliEntry_t * level = instance->commandLinkedListRoot;
+
+    //resolve the completed words, the last (maybe empty) word is the one to complete
+    unsigned int wordStart = 0;
+    for (unsigned int i = 0; i < length; i++)
+    {
+        if( (buffer[i] == '\"') || (buffer[i] == '\'') )
+        {
+            return; //only command paths are completed
+        }
+
+        if(buffer[i] == ' ')
+        {
+            if(i > wordStart)
+            {
+                if(level == NULL)
+                {
+                    return; //already inside the arguments
+                }
+
+                cliEntry_t * child;
+                if(index)
+                {
+                    cliPrefixNode_t * node;
+                    child = prefixIndexFind(index, &buffer[wordStart], i - wordStart, &node);
+                    index = (child ? prefixIndexChild(node, ' ') : NULL);
+                }
+                else
+                {
+                    child = findCommand(level, &buffer[wordStart], i - wordStart);
+                }
+
+                if(child == NULL)
+                {
+                    return;
+                }
+                level = child->subCommandLinkedListRoot;
+            }
+            wordStart = i + 1;
+        }
+    }
+
+    if(level == NULL)
+    {
+        return;
+    }
+
+    const char * word = &buffer[wordStart];
+    unsigned int wordLength = length - wordStart;
+
+    cliEntry_t * unique = NULL;         //only one name left
+    const char * extension = NULL;      //characters shared by all names beyond the word
+    unsigned int extensionLength = 0;
+    cliPrefixNode_t * node = index;
+
+    if(index)
+    {
+        for (unsigned int i = 0; (i < wordLength) && node; i++)
+        {
+            node = prefixIndexChild(node, word[i]);
+        }
+        if(node == NULL)
+        {
+            return;
+        }
+
+        //follow the path as long as it does not branch
+        while( (node->command == NULL) && node->child && (node->child->sibling == NULL) )
+        {
+            node = node->child;
+            extensionLength++;
+        }
+
+        cliPrefixNode_t * representative = node;
+        while(representative->command == NULL)
+        {
+            representative = representative->child;
+        }
+        extension = &representative->command->commandCallName[wordLength];
+        unique = ( (node->command && (node->numCommands == 1)) ? node->command : NULL );
+    }
+    else
+    {
+        unsigned int numCandidates = 0;
+        cliEntry_t * command = level;
+        while(command)
+        {
+            const char * name = command->commandCallName;
+            if(strncmp(word, name, wordLength) == 0)
+            {
+                if(numCandidates++ == 0)
+                {
+                    unique = command;
+                    extension = &name[wordLength];
+                    extensionLength = strlen(extension);
+                }
+                else
+                {
+                    unsigned int shared = 0;
+                    while( (shared < extensionLength) && (name[wordLength + shared] == extension[shared]) )
+                    {
+                        shared++;
+                    }
+                    extensionLength = shared;
+                }
+            }
+
+            //Go to next Command in list
+            command = (command->next != command ? command->next : NULL);
+        }
+
+        if(numCandidates == 0)
+        {
+            return;
+        }
+        unique = (numCandidates == 1 ? unique : NULL);
+    }
+
+    if(extensionLength || unique)
+    {
+        unsigned int space = (instance->inputBufferMaxSize - 1) - length; //always needs space for trailing \0
+        unsigned int added = (extensionLength < space ? extensionLength : space);
+
+        memcpy(&buffer[length], extension, added);
+        if(unique && (added < space))
+        {
+            buffer[length + added++] = ' ';
+        }
+
+        instance->inputBufferFilledSize += added;
+        printOutput(instance, &buffer[length], added);
+    }
+    else
+    {
+        //ambiguous, list the candidates and restore the line
+        printOutput(instance, "\r\n", 2);
+        if(index)
+        {
+            prefixIndexList(instance, node);
+        }
+        else
+        {
+            cliEntry_t * command = level;
+            while(command)
+            {
+                if(strncmp(word, command->commandCallName, wordLength) == 0)
+                {
+                    printOutput(instance, command->commandCallName, strlen(command->commandCallName));
+                    printOutput(instance, "  ", 2);
+                }
+
+                //Go to next Command in list
+                command = (command->next != command ? command->next : NULL);
+            }
+        }
+
+        if(instance->promptMessage)
+        {
+            printOutput(instance, instance->promptMessage, strlen(instance->promptMessage));
+        }
+        else
+        {
+            printOutput(instance, "\r\n", 2);
+        }
+        printOutput(instance, buffer, length);
+    }
+}
+
+#ifdef CLI_ENABLE_STRUCTURED_OUTPUT
+static void emitCommandList(cliInstance_t * instance, cliEntry_t * root);
+#endif
+
+//prints one level of the command tree
+static void printCommandList(cliInstance_t * instance, cliEntry_t * root, cliPrint_func outputFunc)
+{
+    cliEntry_t * entry = root;
+
+#ifdef CLI_ENABLE_STRUCTURED_OUTPUT
+    if(instance->outputFormat != CLI_OUTPUT_TEXT)
+    {
+        emitCommandList(instance, root);
+        return;
+    }
+#else
+    (void) instance;
+#endif
+
+    while (entry)
+    {
+        if(entry->commandHelpText)
+        {
+            //Command
+            outputFunc("[",1);
+            outputFunc(entry->commandCallName,strlen(entry->commandCallName));
+            if(entry->subCommandLinkedListRoot)
+            {
+                outputFunc(" ...",4);
+            }
+            outputFunc("]",1);
+            outputFunc("\r\n", 2);
+            //Help text
+            outputFunc(entry->commandHelpText,strlen(entry->commandHelpText));
+            outputFunc("\r\n", 2);
+            outputFunc("\r\n", 2);
+        }
+
+        //Goto next command
+        entry = ( entry->next != entry ? entry->next : NULL );
+    }
+}
+
+#ifdef CLI_ENABLE_OUTPUT_CACHE
+//Output cache
+//the rendered output of idempotent commands gets stored per argument vector and replayed in one piece
+
+static unsigned int outputCacheHash(unsigned int argc, char ** argv, unsigned int * keyLength)
+{
+    unsigned int hash = 2166136261u; //FNV-1a
+    unsigned int length = 0;
+    for (unsigned int i = 0; i < argc; i++)
+    {
+        const char * c = argv[i];
+        do
+        {
+            hash = (hash ^ (unsigned char) *c) * 16777619u;
+            length++;
+        } while (*c++);
+    }
+    *keyLength = length;
+    return hash;
+}
+
+static bool outputCacheKeyMatches(cliOutputCacheSlot_t * slot, unsigned int argc, char ** argv)
+{
+    const char * key = slot->data;
+    for (unsigned int i = 0; i < argc; i++)
+    {
+        unsigned int length = strlen(argv[i]) + 1;
+        if(memcmp(key, argv[i], length) != 0)
+        {
+            return false;
+        }
+        key += length;
+    }
+    return true;
+}
+
+static bool outputCacheValid(cliInstance_t * instance, cliOutputCacheSlot_t * slot)
+{
+    unsigned int timeToLive = slot->command->outputCacheTimeToLive;
+
+    if(slot->epoch != instance->outputCacheEpoch)
+    {
+        return false;
+    }
+    if(timeToLive == CLI_OUTPUT_CACHE_UNTIL_INVALIDATED)
+    {
+        return true;
+    }
+    if(instance->timeFunction == NULL)
+    {
+        return false; //the age can't be told
+    }
+    return (instance->timeFunction() - slot->timestamp) < timeToLive;
+}
+
+//replays a still valid output in a single call, otherwise starts capturing into a slot
+//returns the slot to finish with outputCacheEnd() or NULL if the command must not be executed
+static cliOutputCacheSlot_t * outputCacheBegin(cliInstance_t * instance, cliEntry_t * command, unsigned int argc, char ** argv, bool * replayed)
+{
+    unsigned int keyLength;
+    unsigned int keyHash = outputCacheHash(argc, argv, &keyLength);
+    cliOutputCacheSlot_t * victim = NULL;
+
+    *replayed = false;
+    if(keyLength > CLI_OUTPUT_CACHE_SLOT_SIZE)
+    {
+        return NULL;
+    }
+
+    for (unsigned int i = 0; i < instance->outputCacheNumSlots; i++)
+    {
+        cliOutputCacheSlot_t * slot = &instance->outputCacheSlots[i];
+
+        if(slot->command == NULL)
+        {
+            victim = (victim ? victim : slot);
+        }
+        else if( (slot->command == command) && (slot->keyHash == keyHash) && (slot->keyLength == keyLength) && outputCacheKeyMatches(slot, argc, argv) )
+        {
+            if(outputCacheValid(instance, slot))
+            {
+                printOutput(instance, &slot->data[keyLength], slot->outputLength);
+                *replayed = true;
+                return NULL;
+            }
+            victim = slot; //stale, refresh in place
+            break;
+        }
+    }
+
+    if(victim == NULL)
+    {
+        victim = &instance->outputCacheSlots[instance->outputCacheNextSlot];
+        instance->outputCacheNextSlot = (instance->outputCacheNextSlot + 1) % instance->outputCacheNumSlots;
+    }
+
+    victim->command = NULL; //only valid once completely captured
+    victim->keyHash = keyHash;
+    victim->keyLength = keyLength;
+    char * key = victim->data;
+    for (unsigned int i = 0; i < argc; i++)
+    {
+        unsigned int length = strlen(argv[i]) + 1;
+        memcpy(key, argv[i], length);
+        key += length;
+    }
+
+    instance->captureBuffer = &victim->data[keyLength];
+    instance->captureSize = CLI_OUTPUT_CACHE_SLOT_SIZE - keyLength;
+    instance->captureLength = 0;
+    instance->captureOverflow = false;
+    instance->capturePassthrough = true;
+    return victim;
+}
+
+static void outputCacheEnd(cliInstance_t * instance, cliEntry_t * command, cliOutputCacheSlot_t * slot)
+{
+    if(!instance->captureOverflow)
+    {
+        slot->command = command;
+        slot->outputLength = instance->captureLength;
+        slot->epoch = instance->outputCacheEpoch;
+        slot->timestamp = (instance->timeFunction ? instance->timeFunction() : 0);
+    }
+    instance->captureBuffer = NULL;
+}
+#endif //CLI_ENABLE_OUTPUT_CACHE
+
+//runs a resolved command, the arguments exclude the command path
+static int executeCommand(cliInstance_t * instance, cliEntry_t * command, unsigned int argc, char ** argv)
+{
+    int status = CLI_STATUS_SUCCESS;
+
+    //route the handler output into this instance
+    cliInstance_t * previousInstance = s_cliActiveInstance;
+    s_cliActiveInstance = instance;
+
+    //a handler running a macro nests executions (previousInstance == instance)
+    //they share the document and the arena of the outer one
+#ifdef CLI_ENABLE_SCRATCH_ARENA
+    unsigned int scratchArenaMark = (previousInstance == instance ? instance->scratchArenaUsed : 0);
+#endif
+
+#ifdef CLI_ENABLE_STRUCTURED_OUTPUT
+    unsigned char emitDepth = instance->emitDepth;
+    bool emitAfterKey = instance->emitAfterKey;
+    if(previousInstance != instance)
+    {
+        //every command starts a new document
+        emitDepth = 0;
+        emitAfterKey = false;
+        instance->emitDepth = 0;
+        instance->emitSiblingMask = 0;
+        instance->emitAfterKey = false;
+    }
+#endif
+
+    if(command->execFunction || command->execFunctionEx)
+    {
+#ifdef CLI_ENABLE_OUTPUT_CACHE
+        cliOutputCacheSlot_t * slot = NULL;
+        bool cacheable = (command->outputCacheTimeToLive == CLI_OUTPUT_CACHE_UNTIL_INVALIDATED) ||
+                         (command->outputCacheTimeToLive && instance->timeFunction);
+        if(cacheable && instance->outputCacheNumSlots && !instance->captureBuffer)
+        {
+            bool replayed;
+            slot = outputCacheBegin(instance, command, argc, argv, &replayed);
+            if(replayed)
+            {
+                s_cliActiveInstance = previousInstance;
+                return CLI_STATUS_SUCCESS;
+            }
+        }
+#endif
+
+        //Exec Command
+        if(command->execFunctionEx)
+        {
+            status = command->execFunctionEx(
+                instance,
+                argc,
+                (argc ? (const char **) argv : NULL),
+                handlerOutputFor(instance)
+            );
+        }
+        else
+        {
+            command->execFunction(
+                argc,
+                (argc ? (const char **) argv : NULL),
+                handlerOutputFor(instance)
+            );
+        }
+
+#ifdef CLI_ENABLE_OUTPUT_CACHE
+        if(slot)
+        {
+            //failed runs are not replayed
+            instance->captureOverflow |= (status != CLI_STATUS_SUCCESS);
+            outputCacheEnd(instance, command, slot);
+        }
+#endif
+    }
+    else
+    {
+        //pure command group, list the next level
+        printCommandList(instance, command->subCommandLinkedListRoot, handlerOutputFor(instance));
+    }
+
+#ifdef CLI_ENABLE_SCRATCH_ARENA
+    //release everything the handler allocated, the allocations of an outer handler stay
+    instance->scratchArenaUsed = scratchArenaMark;
+#endif
+
+#ifdef CLI_ENABLE_STRUCTURED_OUTPUT
+    //a balanced document leaves the depth as it was, otherwise the outer handler continues on its own level
+    if(instance->emitDepth != emitDepth)
+    {
+        instance->emitDepth = emitDepth;
+        instance->emitAfterKey = emitAfterKey;
+    }
+#endif
+
+    s_cliActiveInstance = previousInstance;
+    return status;
+}
+
+//finds the end of the command starting at offset: a ';' or "&&" outside of quotes or the line end
+//separatorLength receives the length of the separator, conditional is set for "&&"
+static unsigned int findCommandEnd(const char * line, unsigned int offset, unsigned int length, unsigned int * separatorLength, bool * conditional)
+{
+    bool escaped = false;
+
+    *separatorLength = 1;
+    *conditional = false;
+
+    for (unsigned int i = offset; i < length; i++)
+    {
+        switch (line[i])
+        {
+            case '\'':
+            case '\"':
+            {
+                escaped = !escaped;
+            }break;
+
+            case ';':
+            {
+                if(!escaped)
+                {
+                    return i;
+                }
+            }break;
+
+            case '&':
+            {
+                if(!escaped && (i + 1 < length) && (line[i + 1] == '&'))
+                {
+                    *separatorLength = 2;
+                    *conditional = true;
+                    return i;
+                }
+            }break;
+
+            default:
+                break;
+        }
+    }
+    return length;
+}
+
+//tokenizes and executes a single command of the line
+//command has to be terminated, length includes the termination
+//returns false for an empty command, status is only set otherwise
+static bool dispatchCommand(cliInstance_t * instance, char * command, unsigned int length, bool * executed, int * status)
+{
+    //check the amount of Arguments
+    unsigned int numArguments = getArguments(
+        command,
+        length,
+        NULL
+    );
+
+    if(numArguments == 0)
+    {
+        return false; //empty command
+    }
+
+    //alloc Argument array in Stack
+    char * argumentsVector[numArguments];
+    //fill Argument Array
+    getArguments(
+        command,
+        length,
+        argumentsVector
+    );
+
+    //descend the command tree, one argument per level
+    unsigned int depth = 0;
+    cliEntry_t * entry = resolveCommand(
+        prefixIndexGet(instance),
+        instance->commandLinkedListRoot,
+        numArguments,
+        argumentsVector,
+        &depth
+    );
+
+    if(entry == NULL)
+    {
+        *status = CLI_STATUS_UNKNOWN_COMMAND;
+        return true;
+    }
+
+    //Found Matching Command
+    if(instance->localEcho && !*executed)
+    {
+        //Lr-Cr before the first exec of the line
+        printOutput(instance, "\n\r",2);
+    }
+    *executed = true;
+
+    *status = executeCommand(
+        instance,
+        entry,
+        (numArguments-depth), //command path is not needed inside the Handler
+        &argumentsVector[depth]
+    );
+    return true;
+}
+
+#if defined(CLI_ENABLE_LINE_EDITOR) || defined(CLI_ENABLE_WATCH)
+//terminal updates are collected into as few output calls as possible
+
+#ifndef CLI_EDITOR_OUTPUT_BATCH_SIZE
+    #define CLI_EDITOR_OUTPUT_BATCH_SIZE 64
+#endif
+
+typedef struct cliOutputBatch_s
+{
+    cliInstance_t * instance;
+    unsigned int length;
+    bool discard;   //edit silently, e.g. without local echo
+    char data[CLI_EDITOR_OUTPUT_BATCH_SIZE];
+}cliOutputBatch_t;
+
+static void batchFlush(cliOutputBatch_t * batch)
+{
+    if(batch->discard)
+    {
+        batch->length = 0;
+    }
+    else if(batch->length)
+    {
+        printOutput(batch->instance, batch->data, batch->length);
+        batch->length = 0;
+    }
+}
+
+static void batchPut(cliOutputBatch_t * batch, const char * data, unsigned int length)
+{
+    while(length)
+    {
+        if(batch->length == sizeof(batch->data))
+        {
+            batchFlush(batch);
+        }
+
+        unsigned int chunk = sizeof(batch->data) - batch->length;
+        chunk = (length < chunk ? length : chunk);
+        memcpy(&batch->data[batch->length], data, chunk);
+        batch->length += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+//ESC [ <count> <command>
+static void batchPutCsi(cliOutputBatch_t * batch, unsigned int count, char command)
+{
+    char sequence[2 + 20 + 1] = {'\x1b', '['};
+    unsigned int length = 2;
+    if(count != 1)
+    {
+        length += ascii_putUnsignedDecimal(&sequence[length], count);
+    }
+    sequence[length++] = command;
+    batchPut(batch, sequence, length);
+}
+#endif
+
+#ifdef CLI_ENABLE_LINE_EDITOR
+//VT100 line editor
+//every edit is answered with the shortest update of the terminal, collected into a single output call
+
+#define CLI_CTRL(key) ((key) & 0x1f)
+
+enum
+{
+    CLI_ESCAPE_NONE,
+    CLI_ESCAPE_STARTED,     // ESC
+    CLI_ESCAPE_CSI,         // ESC [
+    CLI_ESCAPE_SS3,         // ESC O
+    CLI_ESCAPE_MODIFIERS    // ESC [ 1 ; ... the rest up to the final byte is ignored
+};
+
+static unsigned int csiLength(unsigned int count)
+{
+    unsigned int digits = 0;
+    if(count != 1)
+    {
+        do
+        {
+            digits++;
+            count /= 10;
+        } while (count);
+    }
+    return 3 + digits;
+}
+
+static void batchPutCursorLeft(cliOutputBatch_t * batch, unsigned int count)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    if(count <= csiLength(count))
+    {
+        while(count--)
+        {
+            batchPut(batch, "\b", 1);
+        }
+    }
+    else
+    {
+        batchPutCsi(batch, count, 'D');
+    }
+}
+
+//moving right over the line is cheapest done by sending the characters again
+static void batchPutCursorRight(cliOutputBatch_t * batch, unsigned int count)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    if(count <= csiLength(count))
+    {
+        cliInstance_t * instance = batch->instance;
+        batchPut(batch, &instance->inputBuffer[instance->cursorPosition], count);
+    }
+    else
+    {
+        batchPutCsi(batch, count, 'C');
+    }
+}
+
+static void editorMoveCursor(cliOutputBatch_t * batch, unsigned int position)
+{
+    cliInstance_t * instance = batch->instance;
+
+    if(position < instance->cursorPosition)
+    {
+        batchPutCursorLeft(batch, instance->cursorPosition - position);
+    }
+    else
+    {
+        batchPutCursorRight(batch, position - instance->cursorPosition);
+    }
+    instance->cursorPosition = position;
+}
+
+static unsigned int cursorLeftLength(unsigned int count)
+{
+    return (count <= csiLength(count) ? count : csiLength(count));
+}
+
+//removes count characters starting at the cursor
+static void editorDelete(cliOutputBatch_t * batch, unsigned int count)
+{
+    cliInstance_t * instance = batch->instance;
+    if(count == 0)
+    {
+        return;
+    }
+
+    char * cursor = &instance->inputBuffer[instance->cursorPosition];
+    unsigned int tailLength = instance->inputBufferFilledSize - instance->cursorPosition - count;
+    memmove(cursor, cursor + count, tailLength);
+    instance->inputBufferFilledSize -= count;
+
+    //redraw the tail and blank out what is left of the old line end
+    batchPut(batch, cursor, tailLength);
+    if( (count < 4) && ((count + cursorLeftLength(tailLength + count)) <= (3 + cursorLeftLength(tailLength))) )
+    {
+        batchPut(batch, "   ", count);
+        batchPutCursorLeft(batch, tailLength + count);
+    }
+    else
+    {
+        batchPut(batch, "\x1b[K", 3);
+        batchPutCursorLeft(batch, tailLength);
+    }
+}
+
+static void editorInsert(cliOutputBatch_t * batch, char inputChar)
+{
+    cliInstance_t * instance = batch->instance;
+
+    if(instance->inputBufferFilledSize >= (instance->inputBufferMaxSize - 1)) //always needs space for trailing \0
+    {
+        return;
+    }
+
+    char * cursor = &instance->inputBuffer[instance->cursorPosition];
+    unsigned int tailLength = instance->inputBufferFilledSize - instance->cursorPosition;
+    memmove(cursor + 1, cursor, tailLength);
+    *cursor = inputChar;
+    instance->inputBufferFilledSize++;
+    instance->cursorPosition++;
+
+    batchPut(batch, cursor, tailLength + 1);
+    batchPutCursorLeft(batch, tailLength);
+}
+
+#ifdef CLI_ENABLE_HISTORY
+//History ring
+//positions are given as distance back from historyHead (1 = last byte written)
+//walking to a neighbouring line only touches that line, a search is at most one pass over the ring
+
+static char historyAt(cliInstance_t * instance, unsigned int back)
+{
+    return instance->historyBuffer[(instance->historyHead + instance->historyBufferSize - back) % instance->historyBufferSize];
+}
+
+//start of the line in front of the '\0' at terminator, 0 if there is none
+static unsigned int historyLineStart(cliInstance_t * instance, unsigned int terminator)
+{
+    unsigned int back = terminator + 1;
+    while( (back <= instance->historyUsed) && historyAt(instance, back) )
+    {
+        back++;
+    }
+    return (back - 1 > terminator ? back - 1 : 0);
+}
+
+//next older line than start (0 = new line), 0 if there is none
+static unsigned int historyOlder(cliInstance_t * instance, unsigned int start)
+{
+    unsigned int terminator = (start ? start + 1 : 1);
+    if(terminator > instance->historyUsed)
+    {
+        return 0;
+    }
+    return historyLineStart(instance, terminator);
+}
+
+//next newer line than start, 0 if start is the newest one
+static unsigned int historyNewer(cliInstance_t * instance, unsigned int start)
+{
+    while(historyAt(instance, start))
+    {
+        start--;
+    }
+    return (start > 1 ? start - 1 : 0);
+}
+
+static void historyAdd(cliInstance_t * instance, const char * line, unsigned int length)
+{
+    instance->historyRecall = 0;
+    instance->historySearching = false;
+
+    if( (instance->historyBuffer == NULL) || (length == 0) || (length >= instance->historyBufferSize) )
+    {
+        return;
+    }
+
+    //skip repetitions of the newest line
+    unsigned int newest = historyOlder(instance, 0);
+    if(newest == length + 1)
+    {
+        unsigned int i = 0;
+        while( (i < length) && (historyAt(instance, newest - i) == line[i]) )
+        {
+            i++;
+        }
+        if(i == length)
+        {
+            return;
+        }
+    }
+
+    //drop the oldest lines as a whole until the new one fits
+    while(instance->historyUsed + length + 1 > instance->historyBufferSize)
+    {
+        unsigned int back = instance->historyUsed;
+        while(historyAt(instance, back))
+        {
+            back--;
+        }
+        instance->historyUsed = back - 1;
+    }
+
+    for (unsigned int i = 0; i <= length; i++)
+    {
+        instance->historyBuffer[instance->historyHead] = (i < length ? line[i] : '\0');
+        instance->historyHead = (instance->historyHead + 1) % instance->historyBufferSize;
+    }
+    instance->historyUsed += length + 1;
+}
+
+//replaces the edited line by the history line at start (0 = empty line) with a minimal redraw
+static void historyLoad(cliOutputBatch_t * batch, unsigned int start)
+{
+    cliInstance_t * instance = batch->instance;
+    unsigned int oldLength = instance->inputBufferFilledSize;
+    unsigned int length = 0;
+    unsigned int commonLength = 0;
+    bool common = true;
+
+    for (unsigned int back = start; back && historyAt(instance, back) && (length < instance->inputBufferMaxSize - 1); back--)
+    {
+        char c = historyAt(instance, back);
+        common = common && (length < oldLength) && (instance->inputBuffer[length] == c);
+        commonLength += common;
+        instance->inputBuffer[length++] = c;
+    }
+    instance->historyRecall = start;
+
+    //chars in front of commonLength are unchanged, only the rest gets sent
+    if(instance->cursorPosition > commonLength)
+    {
+        editorMoveCursor(batch, commonLength);
+    }
+    batchPut(batch, &instance->inputBuffer[instance->cursorPosition], length - instance->cursorPosition);
+    if(oldLength > length)
+    {
+        batchPut(batch, "\x1b[K", 3);
+    }
+    instance->inputBufferFilledSize = length;
+    instance->cursorPosition = length;
+}
+
+//finds the first line from start on (going older) containing the search pattern, 0 if none
+static unsigned int historySearch(cliInstance_t * instance, unsigned int start)
+{
+    unsigned int patternLength = instance->historySearchLength;
+
+    for ( ; start; start = historyOlder(instance, start))
+    {
+        for (unsigned int back = start; historyAt(instance, back); back--)
+        {
+            unsigned int i = 0;
+            while( (i < patternLength) && (back - i > 0) && (historyAt(instance, back - i) == instance->historySearchPattern[i]) )
+            {
+                i++;
+            }
+            if(i == patternLength)
+            {
+                return start;
+            }
+        }
+    }
+    return 0;
+}
+
+//length of the history line at start, the edited line for start 0
+static unsigned int historySearchLineLength(cliInstance_t * instance, unsigned int start)
+{
+    if(start == 0)
+    {
+        return instance->inputBufferFilledSize;
+    }
+
+    unsigned int length = 0;
+    while( (length < start) && historyAt(instance, start - length) && (length < instance->inputBufferMaxSize - 1) )
+    {
+        length++;
+    }
+    return length;
+}
+
+static char historySearchLineAt(cliInstance_t * instance, unsigned int start, unsigned int position)
+{
+    return (start ? historyAt(instance, start - position) : instance->inputBuffer[position]);
+}
+
+//minimal redraw of the terminal from the line at from to the line at to (history starts, 0 for the edited line)
+static void historySearchRedraw(cliOutputBatch_t * batch, unsigned int from, unsigned int to)
+{
+    cliInstance_t * instance = batch->instance;
+    unsigned int oldLength = historySearchLineLength(instance, from);
+    unsigned int length = historySearchLineLength(instance, to);
+    unsigned int commonLength = 0;
+
+    while( (commonLength < oldLength) && (commonLength < length) &&
+           (historySearchLineAt(instance, from, commonLength) == historySearchLineAt(instance, to, commonLength)) )
+    {
+        commonLength++;
+    }
+
+    if(instance->cursorPosition > commonLength)
+    {
+        editorMoveCursor(batch, commonLength);
+    }
+    for (unsigned int i = instance->cursorPosition; i < length; i++)
+    {
+        char c = historySearchLineAt(instance, to, i);
+        batchPut(batch, &c, 1);
+    }
+    if(oldLength > length)
+    {
+        batchPut(batch, "\x1b[K", 3);
+    }
+    instance->cursorPosition = length;
+}
+
+//Ctrl-R mode, returns false if the char ends the search and needs the usual handling
+//the terminal shows the match at historyRecall, the edited line only takes it over when the search is accepted
+static bool historySearchInputChar(cliOutputBatch_t * batch, char inputChar)
+{
+    cliInstance_t * instance = batch->instance;
+    unsigned int start = instance->historyRecall;
+
+    switch (inputChar)
+    {
+        case CLI_CTRL('R'):
+        {
+            start = historyOlder(instance, start); //next older match
+        }break;
+
+        case '\b':
+        case '\x7f':
+        {
+            if(instance->historySearchLength)
+            {
+                instance->historySearchLength--;
+            }
+            start = historyOlder(instance, 0); //search again from the newest line
+        }break;
+
+        case CLI_CTRL('G'):
+        {
+            //back to the line as it was before the search
+            historySearchRedraw(batch, start, 0);
+            editorMoveCursor(batch, instance->historySearchCursor);
+            instance->historyRecall = 0;
+            instance->historySearching = false;
+            return true;
+        }
+
+        default:
+        {
+            if( ((unsigned char) inputChar < ' ') || (inputChar == '\x7f') )
+            {
+                //keep the found line and edit it
+                if(start)
+                {
+                    unsigned int length = historySearchLineLength(instance, start);
+                    for (unsigned int i = 0; i < length; i++)
+                    {
+                        instance->inputBuffer[i] = historyAt(instance, start - i);
+                    }
+                    instance->inputBufferFilledSize = length;
+                }
+                instance->historySearching = false;
+                return false;
+            }
+
+            if(instance->historySearchLength < sizeof(instance->historySearchPattern))
+            {
+                instance->historySearchPattern[instance->historySearchLength++] = inputChar;
+            }
+            start = (start ? start : historyOlder(instance, 0));
+        }break;
+    }
+
+    start = historySearch(instance, start);
+    if(start)
+    {
+        historySearchRedraw(batch, instance->historyRecall, start);
+        instance->historyRecall = start;
+    }
+    else
+    {
+        batchPut(batch, "\a", 1);
+    }
+    return true;
+}
+#endif //CLI_ENABLE_HISTORY
+
+//handles everything but line end & tab
+//returns false if the char was not consumed by the editor
+static bool editorInputChar(cliInstance_t * instance, char inputChar)
+{
+    cliOutputBatch_t batch = {.instance = instance, .length = 0, .discard = !instance->localEcho};
+    unsigned char escapeState = instance->escapeState;
+    instance->escapeState = CLI_ESCAPE_NONE;
+
+    if(instance->actionPending)
+    {
+        return (inputChar != '\r') && (inputChar != '\n');
+    }
+
+    switch (escapeState)
+    {
+        case CLI_ESCAPE_STARTED:
+        {
+            if( (inputChar == '[') || (inputChar == 'O') )
+            {
+                instance->escapeState = (inputChar == '[' ? CLI_ESCAPE_CSI : CLI_ESCAPE_SS3);
+                instance->escapeParameter = 0;
+                return true;
+            }
+        }break; //lone ESC, handle the char as usual
+
+        case CLI_ESCAPE_CSI:
+        case CLI_ESCAPE_SS3:
+        case CLI_ESCAPE_MODIFIERS:
+        {
+            if( (inputChar >= 0x20) && (inputChar <= 0x3F) ) //parameter & intermediate bytes
+            {
+                if( (escapeState != CLI_ESCAPE_MODIFIERS) && (inputChar >= '0') && (inputChar <= '9') )
+                {
+                    unsigned int parameter = instance->escapeParameter * 10 + (inputChar - '0');
+                    instance->escapeParameter = (parameter > 0xFF ? 0xFF : parameter); //saturated, no key lives up there
+                    instance->escapeState = escapeState;
+                }
+                else
+                {
+                    instance->escapeState = CLI_ESCAPE_MODIFIERS; //only the first parameter selects the key
+                }
+                return true;
+            }
+
+            if(inputChar == '~')
+            {
+                switch (instance->escapeParameter)
+                {
+                    case 1:
+                    case 7:
+                        inputChar = CLI_CTRL('A'); break;
+                    case 4:
+                    case 8:
+                        inputChar = CLI_CTRL('E'); break;
+                    case 3:
+                        inputChar = CLI_CTRL('D'); break;
+                    default:
+                        return true;
+                }
+            }
+            else
+            {
+                switch (inputChar)
+                {
+                    case 'A': inputChar = CLI_CTRL('P'); break;
+                    case 'B': inputChar = CLI_CTRL('N'); break;
+                    case 'C': inputChar = CLI_CTRL('F'); break;
+                    case 'D': inputChar = CLI_CTRL('B'); break;
+                    case 'H': inputChar = CLI_CTRL('A'); break;
+                    case 'F': inputChar = CLI_CTRL('E'); break;
+                    default:
+                        return true; //unsupported sequence, swallow it
+                }
+            }
+        }break;
+
+        default:
+            break;
+    }
+
+#ifdef CLI_ENABLE_HISTORY
+    if(instance->historySearching && historySearchInputChar(&batch, inputChar))
+    {
+        batchFlush(&batch);
+        return true;
+    }
+#endif
+
+    switch (inputChar)
+    {
+        case '\r':
+        case '\n':
+        case '\t':
+            return false;
+
+        case '\x1b':
+        {
+            instance->escapeState = CLI_ESCAPE_STARTED;
+        }break;
+
+        case CLI_CTRL('A'):
+        {
+            editorMoveCursor(&batch, 0);
+        }break;
+
+        case CLI_CTRL('E'):
+        {
+            editorMoveCursor(&batch, instance->inputBufferFilledSize);
+        }break;
+
+        case CLI_CTRL('B'):
+        {
+            if(instance->cursorPosition)
+            {
+                editorMoveCursor(&batch, instance->cursorPosition - 1);
+            }
+        }break;
+
+        case CLI_CTRL('F'):
+        {
+            if(instance->cursorPosition < instance->inputBufferFilledSize)
+            {
+                editorMoveCursor(&batch, instance->cursorPosition + 1);
+            }
+        }break;
+
+        case CLI_CTRL('D'): //delete under the cursor
+        {
+            if(instance->cursorPosition < instance->inputBufferFilledSize)
+            {
+                editorDelete(&batch, 1);
+            }
+        }break;
+
+        case '\b':
+        case '\x7f':
+        {
+            if(instance->cursorPosition)
+            {
+                editorMoveCursor(&batch, instance->cursorPosition - 1);
+                editorDelete(&batch, 1);
+            }
+        }break;
+
+        case CLI_CTRL('K'):
+        {
+            if(instance->cursorPosition < instance->inputBufferFilledSize)
+            {
+                instance->inputBufferFilledSize = instance->cursorPosition;
+                batchPut(&batch, "\x1b[K", 3);
+            }
+        }break;
+
+#ifdef CLI_ENABLE_HISTORY
+        case CLI_CTRL('P'):
+        {
+            if(instance->historyBuffer)
+            {
+                unsigned int older = historyOlder(instance, instance->historyRecall);
+                if(older)
+                {
+                    historyLoad(&batch, older);
+                }
+            }
+        }break;
+
+        case CLI_CTRL('N'):
+        {
+            if(instance->historyBuffer && instance->historyRecall)
+            {
+                historyLoad(&batch, historyNewer(instance, instance->historyRecall));
+            }
+        }break;
+
+        case CLI_CTRL('R'):
+        {
+            if(instance->historyBuffer)
+            {
+                instance->historySearching = true;
+                instance->historySearchCursor = instance->cursorPosition;
+                instance->historySearchLength = 0;
+                instance->historyRecall = 0;
+            }
+        }break;
+#endif
+
+        case CLI_CTRL('U'):
+        {
+            unsigned int count = instance->cursorPosition;
+            editorMoveCursor(&batch, 0);
+            editorDelete(&batch, count);
+        }break;
+
+        default:
+        {
+            if( (unsigned char) inputChar >= ' ' )
+            {
+                editorInsert(&batch, inputChar);
+            }
+        }break;
+    }
+
+    batchFlush(&batch);
+    return true;
+}
+#endif //CLI_ENABLE_LINE_EDITOR
+
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+//Float conversion without libc
+//parsing: Eisel-Lemire with a 64 bit power of five table, the few cases it can not decide
+//(and inputs beyond 19 significant digits) get settled exactly with a small big integer
+//printing: shortest digits which parse back to the same float (Steele & White / Burger & Dybvig)
+
+#define CLI_FLOAT_FAST_DIGITS   19      //significant digits fitting the 64 bit mantissa
+#define CLI_FLOAT_EXACT_DIGITS  120     //enough to decide every float halfway point exactly
+#define CLI_FLOAT_BIG_LIMBS     40      //1280 bit, covers 10^120 * 5^165 * 2^25 comfortably
+
+//5^q for q in [-64, 38], normalized to the top bit, upper 64 bits (same values as fast_float)
+static const uint64_t s_cliPowersOfFive[] =
+{
+    0xa87fea27a539e9a5, 0xd29fe4b18e88640e, 0x83a3eeeef9153e89, 0xa48ceaaab75a8e2b,
+    0xcdb02555653131b6, 0x808e17555f3ebf11, 0xa0b19d2ab70e6ed6, 0xc8de047564d20a8b,
+    0xfb158592be068d2e, 0x9ced737bb6c4183d, 0xc428d05aa4751e4c, 0xf53304714d9265df,
+    0x993fe2c6d07b7fab, 0xbf8fdb78849a5f96, 0xef73d256a5c0f77c, 0x95a8637627989aad,
+    0xbb127c53b17ec159, 0xe9d71b689dde71af, 0x9226712162ab070d, 0xb6b00d69bb55c8d1,
+    0xe45c10c42a2b3b05, 0x8eb98a7a9a5b04e3, 0xb267ed1940f1c61c, 0xdf01e85f912e37a3,
+    0x8b61313bbabce2c6, 0xae397d8aa96c1b77, 0xd9c7dced53c72255, 0x881cea14545c7575,
+    0xaa242499697392d2, 0xd4ad2dbfc3d07787, 0x84ec3c97da624ab4, 0xa6274bbdd0fadd61,
+    0xcfb11ead453994ba, 0x81ceb32c4b43fcf4, 0xa2425ff75e14fc31, 0xcad2f7f5359a3b3e,
+    0xfd87b5f28300ca0d, 0x9e74d1b791e07e48, 0xc612062576589dda, 0xf79687aed3eec551,
+    0x9abe14cd44753b52, 0xc16d9a0095928a27, 0xf1c90080baf72cb1, 0x971da05074da7bee,
+    0xbce5086492111aea, 0xec1e4a7db69561a5, 0x9392ee8e921d5d07, 0xb877aa3236a4b449,
+    0xe69594bec44de15b, 0x901d7cf73ab0acd9, 0xb424dc35095cd80f, 0xe12e13424bb40e13,
+    0x8cbccc096f5088cb, 0xafebff0bcb24aafe, 0xdbe6fecebdedd5be, 0x89705f4136b4a597,
+    0xabcc77118461cefc, 0xd6bf94d5e57a42bc, 0x8637bd05af6c69b5, 0xa7c5ac471b478423,
+    0xd1b71758e219652b, 0x83126e978d4fdf3b, 0xa3d70a3d70a3d70a, 0xcccccccccccccccc,
+    0x8000000000000000, 0xa000000000000000, 0xc800000000000000, 0xfa00000000000000,
+    0x9c40000000000000, 0xc350000000000000, 0xf424000000000000, 0x9896800000000000,
+    0xbebc200000000000, 0xee6b280000000000, 0x9502f90000000000, 0xba43b74000000000,
+    0xe8d4a51000000000, 0x9184e72a00000000, 0xb5e620f480000000, 0xe35fa931a0000000,
+    0x8e1bc9bf04000000, 0xb1a2bc2ec5000000, 0xde0b6b3a76400000, 0x8ac7230489e80000,
+    0xad78ebc5ac620000, 0xd8d726b7177a8000, 0x878678326eac9000, 0xa968163f0a57b400,
+    0xd3c21bcecceda100, 0x84595161401484a0, 0xa56fa5b99019a5c8, 0xcecb8f27f4200f3a,
+    0x813f3978f8940984, 0xa18f07d736b90be5, 0xc9f2c9cd04674ede, 0xfc6f7c4045812296,
+    0x9dc5ada82b70b59d, 0xc5371912364ce305, 0xf684df56c3e01bc6, 0x9a130b963a6c115c,
+    0xc097ce7bc90715b3, 0xf0bdc21abb48db20, 0x96769950b50d88f4,
+};
+
+typedef struct cliBigInt_s
+{
+    uint32_t limb[CLI_FLOAT_BIG_LIMBS]; //little endian
+    unsigned int length;
+}cliBigInt_t;
+
+static void bigSet(cliBigInt_t * big, uint32_t value)
+{
+    big->limb[0] = value;
+    big->length = (value ? 1 : 0);
+}
+
+static void bigMulAdd(cliBigInt_t * big, uint32_t factor, uint32_t addend)
+{
+    uint64_t carry = addend;
+    for (unsigned int i = 0; i < big->length; i++)
+    {
+        carry += (uint64_t) big->limb[i] * factor;
+        big->limb[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    if(carry && (big->length < CLI_FLOAT_BIG_LIMBS))
+    {
+        big->limb[big->length++] = (uint32_t) carry;
+    }
+}
+
+static void bigMulPow5(cliBigInt_t * big, unsigned int exponent)
+{
+    while(exponent >= 13)
+    {
+        bigMulAdd(big, 1220703125, 0); //5^13
+        exponent -= 13;
+    }
+    static const uint32_t smallPowers[] = {1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625};
+    bigMulAdd(big, smallPowers[exponent], 0);
+}
+
+static void bigShiftLeft(cliBigInt_t * big, unsigned int bits)
+{
+    unsigned int limbs = bits / 32;
+    bits %= 32;
+
+    if(big->length == 0)
+    {
+        return;
+    }
+
+    if(bits)
+    {
+        uint32_t carry = 0;
+        for (unsigned int i = 0; i < big->length; i++)
+        {
+            uint32_t limb = big->limb[i];
+            big->limb[i] = (limb << bits) | carry;
+            carry = limb >> (32 - bits);
+        }
+        if(carry && (big->length < CLI_FLOAT_BIG_LIMBS))
+        {
+            big->limb[big->length++] = carry;
+        }
+    }
+
+    if(limbs)
+    {
+        if(big->length + limbs > CLI_FLOAT_BIG_LIMBS)
+        {
+            limbs = CLI_FLOAT_BIG_LIMBS - big->length;
+        }
+        memmove(&big->limb[limbs], big->limb, big->length * sizeof(uint32_t));
+        memset(big->limb, 0, limbs * sizeof(uint32_t));
+        big->length += limbs;
+    }
+}
+
+static int bigCompare(const cliBigInt_t * a, const cliBigInt_t * b)
+{
+    if(a->length != b->length)
+    {
+        return (a->length > b->length ? 1 : -1);
+    }
+    for (unsigned int i = a->length; i-- > 0; )
+    {
+        if(a->limb[i] != b->limb[i])
+        {
+            return (a->limb[i] > b->limb[i] ? 1 : -1);
+        }
+    }
+    return 0;
+}
+
+//sum = a + b
+static void bigAdd(cliBigInt_t * sum, const cliBigInt_t * a, const cliBigInt_t * b)
+{
+    const cliBigInt_t * longer = (a->length >= b->length ? a : b);
+    const cliBigInt_t * shorter = (a->length >= b->length ? b : a);
+    uint64_t carry = 0;
+
+    for (unsigned int i = 0; i < longer->length; i++)
+    {
+        carry += longer->limb[i];
+        carry += (i < shorter->length ? shorter->limb[i] : 0);
+        sum->limb[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    sum->length = longer->length;
+    if(carry && (sum->length < CLI_FLOAT_BIG_LIMBS))
+    {
+        sum->limb[sum->length++] = (uint32_t) carry;
+    }
+}
+
+//a -= b, requires a >= b
+static void bigSubtract(cliBigInt_t * a, const cliBigInt_t * b)
+{
+    int64_t borrow = 0;
+    for (unsigned int i = 0; i < a->length; i++)
+    {
+        borrow += (int64_t) a->limb[i] - (i < b->length ? b->limb[i] : 0);
+        a->limb[i] = (uint32_t) borrow;
+        borrow = (borrow < 0 ? -1 : 0);
+    }
+    while(a->length && (a->limb[a->length - 1] == 0))
+    {
+        a->length--;
+    }
+}
+
+//splits a decimal literal into mantissa digits and exponent: value = digits * 10^exponent
+//the first maxDigits significant digits go into mantissa (and big if given)
+//truncated is set if a dropped digit was not zero
+//returns false on a malformed literal
+static bool parseDecimal(const char * str, unsigned int maxDigits, uint64_t * mantissa, cliBigInt_t * big, int * exponent, bool * truncated, bool * negative)
+{
+    unsigned int numSignificant = 0;
+    unsigned int numDigits = 0;
+    bool fraction = false;
+    int exponent10 = 0;
+    uint32_t chunk = 0;
+    unsigned int chunkDigits = 0;
+
+    *mantissa = 0;
+    *truncated = false;
+    *negative = (*str == '-');
+    if(big)
+    {
+        bigSet(big, 0);
+    }
+
+    if( (*str == '-') || (*str == '+') )
+    {
+        str++;
+    }
+
+    for ( ; ; str++)
+    {
+        if(*str == '.')
+        {
+            if(fraction)
+            {
+                return false;
+            }
+            fraction = true;
+            continue;
+        }
+
+        if( (*str < '0') || (*str > '9') )
+        {
+            break;
+        }
+
+        unsigned int digit = *str - '0';
+        numDigits++;
+
+        if( (numSignificant == 0) && (digit == 0) )
+        {
+            exponent10 -= fraction; //leading zero
+            continue;
+        }
+
+        if(numSignificant++ < maxDigits)
+        {
+            *mantissa = *mantissa * 10 + digit;
+            exponent10 -= fraction;
+
+            if(big)
+            {
+                //collect 9 digits per big integer step
+                chunk = chunk * 10 + digit;
+                if(++chunkDigits == 9)
+                {
+                    bigMulAdd(big, 1000000000, chunk);
+                    chunk = 0;
+                    chunkDigits = 0;
+                }
+            }
+        }
+        else
+        {
+            exponent10 += !fraction;
+            *truncated |= (digit != 0);
+        }
+    }
+
+    if(numDigits == 0)
+    {
+        return false;
+    }
+
+    if( (*str == 'e') || (*str == 'E') )
+    {
+        str++;
+        bool negativeExponent = (*str == '-');
+        if( (*str == '-') || (*str == '+') )
+        {
+            str++;
+        }
+        if( (*str < '0') || (*str > '9') )
+        {
+            return false;
+        }
+
+        int explicitExponent = 0;
+        for ( ; (*str >= '0') && (*str <= '9'); str++)
+        {
+            if(explicitExponent < 100000) //far beyond any float, avoids overflow
+            {
+                explicitExponent = explicitExponent * 10 + (*str - '0');
+            }
+        }
+        exponent10 += (negativeExponent ? -explicitExponent : explicitExponent);
+    }
+
+    if(big && chunkDigits)
+    {
+        static const uint32_t powersOfTen[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+        bigMulAdd(big, powersOfTen[chunkDigits], chunk);
+    }
+
+    *exponent = exponent10;
+    return (*str == '\0');
+}
+
+static unsigned int leadingZeros64(uint64_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#else
+    unsigned int count = 0;
+    while(!(value & 0x8000000000000000ull))
+    {
+        value <<= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+static uint64_t multiplyHigh64(uint64_t a, uint64_t b, uint64_t * low)
+{
+    uint64_t aLow = (uint32_t) a, aHigh = a >> 32;
+    uint64_t bLow = (uint32_t) b, bHigh = b >> 32;
+
+    uint64_t lowLow = aLow * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t highHigh = aHigh * bHigh;
+
+    uint64_t middle = (lowLow >> 32) + (uint32_t) lowHigh + (uint32_t) highLow;
+    *low = (middle << 32) | (uint32_t) lowLow;
+    return highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+}
+
+//Eisel-Lemire: float bits of mantissa * 10^exponent (mantissa != 0)
+//ambiguous is set if the truncated power of five does not allow a decision
+static uint32_t floatEiselLemire(uint64_t mantissa, int exponent, bool * ambiguous)
+{
+    *ambiguous = false;
+
+    if(exponent < -64)
+    {
+        return 0;
+    }
+    if(exponent > 38)
+    {
+        return 0x7F800000;
+    }
+
+    unsigned int leadingZeros = leadingZeros64(mantissa);
+    mantissa <<= leadingZeros;
+
+    uint64_t low;
+    uint64_t high = multiplyHigh64(mantissa, s_cliPowersOfFive[exponent + 64], &low);
+
+    //all bits below the 23+3 bit precision set: the missing low part of 5^q might carry into them
+    if( (high & 0x3FFFFFFFFFull) == 0x3FFFFFFFFFull )
+    {
+        *ambiguous = true;
+    }
+
+    unsigned int upperBit = high >> 63;
+    uint64_t bits = high >> (upperBit + 64 - 23 - 3);
+    int power2 = ((((152170 + 65536) * exponent) >> 16) + 63) + upperBit - leadingZeros + 127;
+
+    if(power2 <= 0)
+    {
+        //subnormal
+        if(-power2 + 1 >= 64)
+        {
+            return 0;
+        }
+        bits >>= -power2 + 1;
+        bits += (bits & 1);
+        bits >>= 1;
+        return (uint32_t) bits; //a carry into bit 23 makes it the smallest normal
+    }
+
+    //exact halfway case, round to even
+    if( (low <= 1) && (exponent >= -17) && (exponent <= 10) && ((bits & 3) == 1) )
+    {
+        if((bits << (upperBit + 64 - 23 - 3)) == high)
+        {
+            bits &= ~(uint64_t) 1;
+        }
+    }
+
+    bits += (bits & 1);
+    bits >>= 1;
+    if(bits >= (2u << 23))
+    {
+        bits = (1u << 23);
+        power2++;
+    }
+    bits &= ~(uint64_t) (1u << 23);
+
+    if(power2 >= 0xFF)
+    {
+        return 0x7F800000;
+    }
+    return ((uint32_t) power2 << 23) | (uint32_t) bits;
+}
+
+//compares digits * 10^exponent with the point halfway between the floats bits and bits + 1
+static int floatCompareHalfway(const cliBigInt_t * digits, int exponent, uint32_t bits)
+{
+    uint32_t significand = bits & 0x7FFFFF;
+    int power2 = -149;
+    if(bits >> 23)
+    {
+        significand |= (1u << 23);
+        power2 = (int) (bits >> 23) - 150;
+    }
+
+    //halfway = (2 * significand + 1) * 2^(power2 - 1)
+    cliBigInt_t value = *digits;
+    cliBigInt_t halfway;
+    bigSet(&halfway, 2 * significand + 1);
+
+    if(exponent >= 0)
+    {
+        bigMulPow5(&value, exponent);
+    }
+    else
+    {
+        bigMulPow5(&halfway, -exponent);
+    }
+
+    int shift = exponent - (power2 - 1);
+    if(shift >= 0)
+    {
+        bigShiftLeft(&value, shift);
+    }
+    else
+    {
+        bigShiftLeft(&halfway, -shift);
+    }
+
+    return bigCompare(&value, &halfway);
+}
+
+//settles a candidate which is at most one float off exactly
+static uint32_t floatCorrect(const char * str, uint32_t candidate)
+{
+    uint64_t mantissa;
+    cliBigInt_t digits;
+    int exponent;
+    bool truncated;
+    bool negative;
+
+    parseDecimal(str, CLI_FLOAT_EXACT_DIGITS, &mantissa, &digits, &exponent, &truncated, &negative);
+
+    for (;;)
+    {
+        if(candidate < 0x7F800000)
+        {
+            int compare = floatCompareHalfway(&digits, exponent, candidate);
+            if( (compare > 0) || ((compare == 0) && (truncated || (candidate & 1))) )
+            {
+                candidate++;
+                continue;
+            }
+        }
+
+        if(candidate > 0)
+        {
+            int compare = floatCompareHalfway(&digits, exponent, candidate - 1);
+            if( (compare < 0) || ((compare == 0) && !truncated && (candidate & 1)) )
+            {
+                candidate--;
+                continue;
+            }
+        }
+        return candidate;
+    }
+}
+
+static float floatFromBits(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static uint32_t floatToBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+//returns false on a malformed literal
+static bool parseFloat(const char * str, float * result)
+{
+    uint64_t mantissa;
+    int exponent;
+    bool truncated;
+    bool negative;
+
+    if(!parseDecimal(str, CLI_FLOAT_FAST_DIGITS, &mantissa, NULL, &exponent, &truncated, &negative))
+    {
+        return false;
+    }
+
+    uint32_t sign = (negative ? 0x80000000u : 0);
+    if(mantissa == 0)
+    {
+        *result = floatFromBits(sign);
+        return true;
+    }
+
+    //Clinger: mantissa and power of ten are exact floats, a single rounding is correct
+    if( !truncated && (exponent >= -10) && (exponent <= 10) && (mantissa <= (1u << 24)) )
+    {
+        static const float powersOfTen[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+        float value = (float) mantissa;
+        value = (exponent < 0 ? value / powersOfTen[-exponent] : value * powersOfTen[exponent]);
+        *result = (negative ? -value : value);
+        return true;
+    }
+
+    bool ambiguous;
+    uint32_t bits = floatEiselLemire(mantissa, exponent, &ambiguous);
+    if(truncated && !ambiguous)
+    {
+        //the dropped digits only matter if they could push the value to the next float
+        bool ambiguousUpper;
+        ambiguous = (floatEiselLemire(mantissa + 1, exponent, &ambiguousUpper) != bits) || ambiguousUpper;
+    }
+
+    if(ambiguous)
+    {
+        bits = floatCorrect(str, bits);
+    }
+
+    *result = floatFromBits(bits | sign);
+    return true;
+}
+
+//shortest decimal digits of a finite positive float, returns the number of digits
+//value = 0.digits * 10^decimalExponent
+static unsigned int floatShortestDigits(uint32_t bits, char * digits, int * decimalExponent)
+{
+    uint32_t significand = bits & 0x7FFFFF;
+    unsigned int biasedExponent = bits >> 23;
+    int power2 = -149;
+    if(biasedExponent)
+    {
+        significand |= (1u << 23);
+        power2 = (int) biasedExponent - 150;
+    }
+
+    //value = r / s, the neighbours are (r - marginLow) / s and (r + marginHigh) / s (all scaled by 2)
+    cliBigInt_t r, s, marginLow, marginHigh;
+    bool boundary = (significand == (1u << 23)) && (biasedExponent > 1); //lower neighbour is closer
+    bool even = !(significand & 1);
+
+    bigSet(&r, significand);
+    bigSet(&s, 1);
+    bigSet(&marginLow, 1);
+    if(power2 >= 0)
+    {
+        bigShiftLeft(&r, power2 + 1 + boundary);
+        bigShiftLeft(&s, 1 + boundary);
+        bigShiftLeft(&marginLow, power2);
+    }
+    else
+    {
+        bigShiftLeft(&r, 1 + boundary);
+        bigShiftLeft(&s, -power2 + 1 + boundary);
+    }
+    marginHigh = marginLow;
+    if(boundary)
+    {
+        bigShiftLeft(&marginHigh, 1);
+    }
+
+    //estimate the decimal exponent from below, the loop below fixes it up
+    int bitLength = 64 - (int) leadingZeros64(significand) + power2;
+    int estimate = (bitLength - 1) * 78913;
+    estimate = (estimate >= 0 ? (estimate + (1 << 18) - 1) >> 18 : -((-estimate) >> 18)) - 1;
+
+    if(estimate >= 0)
+    {
+        bigMulPow5(&s, estimate);
+        bigShiftLeft(&s, estimate);
+    }
+    else
+    {
+        bigMulPow5(&r, -estimate);
+        bigShiftLeft(&r, -estimate);
+        bigMulPow5(&marginLow, -estimate);
+        bigShiftLeft(&marginLow, -estimate);
+        bigMulPow5(&marginHigh, -estimate);
+        bigShiftLeft(&marginHigh, -estimate);
+    }
+
+    cliBigInt_t sum;
+    for (;;)
+    {
+        bigAdd(&sum, &r, &marginHigh);
+        int compare = bigCompare(&sum, &s);
+        if( (compare < 0) || ((compare == 0) && !even) )
+        {
+            break;
+        }
+        bigMulAdd(&s, 10, 0);
+        estimate++;
+    }
+    *decimalExponent = estimate;
+
+    unsigned int numDigits = 0;
+    for (;;)
+    {
+        bigMulAdd(&r, 10, 0);
+        bigMulAdd(&marginLow, 10, 0);
+        bigMulAdd(&marginHigh, 10, 0);
+
+        unsigned int digit = 0;
+        while(bigCompare(&r, &s) >= 0)
+        {
+            bigSubtract(&r, &s);
+            digit++;
+        }
+
+        int compareLow = bigCompare(&r, &marginLow);
+        bigAdd(&sum, &r, &marginHigh);
+        int compareHigh = bigCompare(&sum, &s);
+
+        bool low = (even ? compareLow <= 0 : compareLow < 0);
+        bool high = (even ? compareHigh >= 0 : compareHigh > 0);
+
+        if(low && high)
+        {
+            //both ends are in reach, take the closer one
+            bigAdd(&sum, &r, &r);
+            int compare = bigCompare(&sum, &s);
+            digit += ( (compare > 0) || ((compare == 0) && (digit & 1)) );
+        }
+        else if(high)
+        {
+            digit++;
+        }
+
+        digits[numDigits++] = '0' + digit;
+        if(low || high)
+        {
+            return numDigits;
+        }
+    }
+}
+
+#define CLI_FLOAT_STRING_SIZE 16 // -0.000123456789 (15 chars), -1.23456789e-45 (15 chars)
+
+//renders the shortest representation which parses back to the same float, returns the length
+//plain notation for 1e-4 <= |num| < 1e9, scientific otherwise
+static unsigned int formatFloat(char * buffer, float num)
+{
+    char digits[9];  // floats never need more than 9 significant digits
+    unsigned int len = 0;
+    uint32_t bits = floatToBits(num);
+
+    if(bits & 0x80000000u)
+    {
+        buffer[len++] = '-';
+        bits &= 0x7FFFFFFF;
+    }
+
+    if(bits >= 0x7F800000)
+    {
+        if(bits > 0x7F800000)
+        {
+            memcpy(buffer, "nan", 3);
+            return 3;
+        }
+        memcpy(&buffer[len], "inf", 3);
+        return len + 3;
+    }
+
+    if(bits == 0)
+    {
+        buffer[len++] = '0';
+        return len;
+    }
+
+    int decimalExponent;
+    unsigned int numDigits = floatShortestDigits(bits, digits, &decimalExponent);
+
+    if( (decimalExponent > -4) && (decimalExponent <= 9) )
+    {
+        if(decimalExponent <= 0)
+        {
+            buffer[len++] = '0';
+            buffer[len++] = '.';
+            for (int i = decimalExponent; i < 0; i++)
+            {
+                buffer[len++] = '0';
+            }
+            memcpy(&buffer[len], digits, numDigits);
+            len += numDigits;
+        }
+        else
+        {
+            for (int i = 0; i < decimalExponent; i++)
+            {
+                buffer[len++] = ((unsigned int) i < numDigits ? digits[i] : '0');
+            }
+            if(numDigits > (unsigned int) decimalExponent)
+            {
+                buffer[len++] = '.';
+                memcpy(&buffer[len], &digits[decimalExponent], numDigits - decimalExponent);
+                len += numDigits - decimalExponent;
+            }
+        }
+    }
+    else
+    {
+        buffer[len++] = digits[0];
+        if(numDigits > 1)
+        {
+            buffer[len++] = '.';
+            memcpy(&buffer[len], &digits[1], numDigits - 1);
+            len += numDigits - 1;
+        }
+
+        int exponent = decimalExponent - 1;
+        buffer[len++] = 'e';
+        if(exponent < 0)
+        {
+            buffer[len++] = '-';
+            exponent = -exponent;
+        }
+        if(exponent >= 10)
+        {
+            buffer[len++] = '0' + exponent / 10;
+        }
+        buffer[len++] = '0' + exponent % 10;
+    }
+
+    return len;
+}
+#endif //CLI_ENABLE_FLOAT_ARGUMENTS
+
+#ifdef CLI_ENABLE_STRUCTURED_OUTPUT
+//Structured output
+//handlers describe their result through the emitter, which renders it straight into the instance output
+//no document tree is built, the only state is the nesting depth and one "has sibling" bit per level
+
+static void emitTlvHeader(cliInstance_t * instance, unsigned char tag, unsigned int length)
+{
+    unsigned char header[1 + 5]; //tag + varint of 32 bit
+    header[0] = tag;
+    printOutput(instance, (const char *) header, 1 + putVarint(&header[1], length));
+}
+
+//separator and layout in front of a key or a value
+static void emitSeparator(cliInstance_t * instance, bool key)
+{
+    if(instance->emitAfterKey)
+    {
+        //value of a key, already placed
+        instance->emitAfterKey = false;
+        return;
+    }
+
+    unsigned int siblingBit = 1u << instance->emitDepth;
+    bool first = !(instance->emitSiblingMask & siblingBit);
+    instance->emitSiblingMask |= siblingBit;
+
+    if(instance->outputFormat == CLI_OUTPUT_JSON)
+    {
+        if(!first)
+        {
+            printOutput(instance, ",", 1);
+        }
+    }
+    else if( (instance->outputFormat == CLI_OUTPUT_TEXT) && instance->emitDepth )
+    {
+        //one key or array element per line, indented by the nesting depth
+        static const char indent[] = "                ";
+        if(!first || (instance->emitDepth > 1))
+        {
+            printOutput(instance, "\r\n", 2);
+        }
+
+        unsigned int indentLength = 2 * (instance->emitDepth - 1);
+        printOutput(instance, indent, (indentLength < sizeof(indent) - 1 ? indentLength : sizeof(indent) - 1));
+        if(!key)
+        {
+            printOutput(instance, "- ", 2);
+        }
+    }
+}
+
+static void emitBegin(cliInstance_t * instance, char open, unsigned char tag)
+{
+    CLI_ASSERT(instance->emitDepth < 31);
+
+    emitSeparator(instance, false);
+    if(instance->outputFormat == CLI_OUTPUT_JSON)
+    {
+        printOutput(instance, &open, 1);
+    }
+    else if(instance->outputFormat == CLI_OUTPUT_TLV)
+    {
+        emitTlvHeader(instance, tag, 0);
+    }
+
+    instance->emitDepth++;
+    instance->emitSiblingMask &= ~(1u << instance->emitDepth);
+}
+
+static void emitEnd(cliInstance_t * instance, char close, unsigned char tag)
+{
+    CLI_ASSERT(instance->emitDepth);
+
+    instance->emitDepth--;
+    if(instance->outputFormat == CLI_OUTPUT_JSON)
+    {
+        printOutput(instance, &close, 1);
+    }
+    else if(instance->outputFormat == CLI_OUTPUT_TLV)
+    {
+        emitTlvHeader(instance, tag, 0);
+    }
+
+    if( (instance->emitDepth == 0) && (instance->outputFormat != CLI_OUTPUT_TLV) )
+    {
+        //one document per line
+        printOutput(instance, "\r\n", 2);
+    }
+}
+
+//JSON string with escaping, unescaped runs go out in one piece
+static void emitJsonString(cliInstance_t * instance, const char * str, unsigned int length)
+{
+    unsigned int runStart = 0;
+
+    printOutput(instance, "\"", 1);
+    for (unsigned int i = 0; i < length; i++)
+    {
+        unsigned char c = str[i];
+        if( (c >= ' ') && (c != '"') && (c != '\\') )
+        {
+            continue;
+        }
+
+        printOutput(instance, &str[runStart], i - runStart);
+        runStart = i + 1;
+
+        char escape[6] = {'\\', c, '0', '0', 0, 0};
+        if( (c == '"') || (c == '\\') )
+        {
+            printOutput(instance, escape, 2);
+        }
+        else
+        {
+            //control character
+            escape[1] = 'u';
+            ascii_putByteHex(&escape[4], c);
+            printOutput(instance, escape, 6);
+        }
+    }
+    printOutput(instance, &str[runStart], length - runStart);
+    printOutput(instance, "\"", 1);
+}
+
+static void emitKey(cliInstance_t * instance, const char * key)
+{
+    unsigned int length = strlen(key);
+
+    emitSeparator(instance, true);
+    switch (instance->outputFormat)
+    {
+        case CLI_OUTPUT_JSON:
+        {
+            emitJsonString(instance, key, length);
+            printOutput(instance, ":", 1);
+        }break;
+
+        case CLI_OUTPUT_TLV:
+        {
+            emitTlvHeader(instance, CLI_TLV_KEY, length);
+            printOutput(instance, key, length);
+        }break;
+
+        default:
+        {
+            printOutput(instance, key, length);
+            printOutput(instance, ": ", 2);
+        }break;
+    }
+    instance->emitAfterKey = true;
+}
+
+static void emitTlvVarint(cliInstance_t * instance, unsigned char tag, unsigned int value)
+{
+    unsigned char varint[5];
+    unsigned int length = putVarint(varint, value);
+
+    emitTlvHeader(instance, tag, length);
+    printOutput(instance, (const char *) varint, length);
+}
+
+static void emitNumber(cliInstance_t * instance, unsigned int magnitude, bool negative, unsigned char tag)
+{
+    emitSeparator(instance, false);
+    if(instance->outputFormat == CLI_OUTPUT_TLV)
+    {
+        //zigzag for signed values: 0, -1, 1, -2 ... -> 0, 1, 2, 3 ...
+        unsigned int value = magnitude;
+        if(tag == CLI_TLV_INT)
+        {
+            value = (negative ? ((magnitude - 1) << 1) | 1 : magnitude << 1);
+        }
+        emitTlvVarint(instance, tag, value);
+        return;
+    }
+
+    char buffer[1 + 10]; // -4294967295 (11 chars)
+    unsigned int length = 0;
+    if(negative)
+    {
+        buffer[length++] = '-';
+    }
+    length += ascii_putUnsignedDecimal(&buffer[length], magnitude);
+    printOutput(instance, buffer, length);
+}
+
+static void emitString(cliInstance_t * instance, const char * str)
+{
+    unsigned int length = strlen(str);
+
+    emitSeparator(instance, false);
+    switch (instance->outputFormat)
+    {
+        case CLI_OUTPUT_JSON:
+        {
+            emitJsonString(instance, str, length);
+        }break;
+
+        case CLI_OUTPUT_TLV:
+        {
+            emitTlvHeader(instance, CLI_TLV_STRING, length);
+            printOutput(instance, str, length);
+        }break;
+
+        default:
+        {
+            printOutput(instance, str, length);
+        }break;
+    }
+}
+
+static void emitByteArray(cliInstance_t * instance, const unsigned char * bytes, unsigned int length)
+{
+    emitSeparator(instance, false);
+    if(instance->outputFormat == CLI_OUTPUT_TLV)
+    {
+        emitTlvHeader(instance, CLI_TLV_BYTES, length);
+        printOutput(instance, (const char *) bytes, length);
+        return;
+    }
+
+    //JSON: "0a1b2c", text: the argument literal {0a,1b,2c}
+    bool json = (instance->outputFormat == CLI_OUTPUT_JSON);
+    char buffer[3 * 8];
+    unsigned int bufferLength = 0;
+
+    printOutput(instance, (json ? "\"" : "{"), 1);
+    for (unsigned int i = 0; i < length; i++)
+    {
+        if(!json && i)
+        {
+            buffer[bufferLength++] = ',';
+        }
+        ascii_putByteHex(&buffer[bufferLength], bytes[i]);
+        bufferLength += 2;
+
+        if(bufferLength > sizeof(buffer) - 3)
+        {
+            printOutput(instance, buffer, bufferLength);
+            bufferLength = 0;
+        }
+    }
+    printOutput(instance, buffer, bufferLength);
+    printOutput(instance, (json ? "\"" : "}"), 1);
+}
+
+static void emitBool(cliInstance_t * instance, bool value)
+{
+    emitSeparator(instance, false);
+    if(instance->outputFormat == CLI_OUTPUT_TLV)
+    {
+        unsigned char payload = value;
+        emitTlvHeader(instance, CLI_TLV_BOOL, 1);
+        printOutput(instance, (const char *) &payload, 1);
+        return;
+    }
+
+    printOutput(instance, (value ? "true" : "false"), (value ? 4 : 5));
+}
+
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+static void emitFloat(cliInstance_t * instance, float value)
+{
+    emitSeparator(instance, false);
+    if(instance->outputFormat == CLI_OUTPUT_TLV)
+    {
+        uint32_t bits = floatToBits(value);
+        unsigned char payload[4] = {bits, bits >> 8, bits >> 16, bits >> 24}; //little endian
+        emitTlvHeader(instance, CLI_TLV_FLOAT, sizeof(payload));
+        printOutput(instance, (const char *) payload, sizeof(payload));
+        return;
+    }
+
+    if( (instance->outputFormat == CLI_OUTPUT_JSON) && ((floatToBits(value) & 0x7F800000) == 0x7F800000) )
+    {
+        //JSON has no inf and nan
+        printOutput(instance, "null", 4);
+        return;
+    }
+
+    char buffer[CLI_FLOAT_STRING_SIZE];
+    unsigned int length = formatFloat(buffer, value);
+    printOutput(instance, buffer, length);
+}
+#endif
+
+//[{"name":"net","help":"network commands","group":true}, ...]
+static void emitCommandList(cliInstance_t * instance, cliEntry_t * root)
+{
+    emitBegin(instance, '[', CLI_TLV_ARRAY_BEGIN);
+    for (cliEntry_t * entry = root; entry; entry = ( entry->next != entry ? entry->next : NULL ))
+    {
+        if(entry->commandHelpText)
+        {
+            emitBegin(instance, '{', CLI_TLV_OBJECT_BEGIN);
+            emitKey(instance, "name");
+            emitString(instance, entry->commandCallName);
+            emitKey(instance, "help");
+            emitString(instance, entry->commandHelpText);
+            emitKey(instance, "group");
+            emitBool(instance, entry->subCommandLinkedListRoot != NULL);
+            emitEnd(instance, '}', CLI_TLV_OBJECT_END);
+        }
+    }
+    emitEnd(instance, ']', CLI_TLV_ARRAY_END);
+}
+#endif //CLI_ENABLE_STRUCTURED_OUTPUT
+
+#ifdef CLI_ENABLE_WATCH
+//cli_watch(): reruns the command and redraws only the rows which changed since the previous run
+//the cursor rests at the start of the row below the output, rows must not be wider than the terminal
+
+//finds the line at *offset and moves *offset behind its end ("\n", "\r", "\r\n" or "\n\r")
+static unsigned int watchNextLine(const char * text, unsigned int length, unsigned int * offset, unsigned int * lineLength)
+{
+    unsigned int start = *offset;
+    unsigned int end = start;
+    while( (end < length) && (text[end] != '\n') && (text[end] != '\r') )
+    {
+        end++;
+    }
+    *lineLength = end - start;
+
+    if(end < length)
+    {
+        char lineEnd = text[end++];
+        if( (end < length) && (text[end] == ('\n' + '\r' - lineEnd)) )
+        {
+            end++;
+        }
+    }
+    *offset = end;
+    return start;
+}
+
+static void watchRun(cliInstance_t * instance)
+{
+    unsigned int half = (instance->watchBufferSize - instance->watchArgumentsLength) / 2;
+    char * previous = &instance->watchBuffer[instance->watchArgumentsLength + (instance->watchSwap ? half : 0)];
+    char * current = &instance->watchBuffer[instance->watchArgumentsLength + (instance->watchSwap ? 0 : half)];
+
+    //the arguments are stored terminated, no tokenizing needed
+    char * argumentsVector[instance->watchArgc + 1];
+    char * argument = instance->watchBuffer;
+    for (unsigned int i = 0; i < instance->watchArgc; i++)
+    {
+        argumentsVector[i] = argument;
+        argument += strlen(argument) + 1;
+    }
+
+    instance->captureBuffer = current;
+    instance->captureSize = half;
+    instance->captureLength = 0;
+    instance->captureOverflow = false;
+    instance->capturePassthrough = false;
+    executeCommand(instance, instance->watchCommand, instance->watchArgc, argumentsVector);
+    instance->captureBuffer = NULL;
+
+    unsigned int currentLength = instance->captureLength;
+    unsigned int currentOffset = 0;
+    unsigned int previousOffset = 0;
+    unsigned int row = 0;
+    unsigned int cursor = instance->watchLines;
+    cliOutputBatch_t batch = {.instance = instance};
+
+    while(currentOffset < currentLength)
+    {
+        unsigned int lineLength;
+        unsigned int line = watchNextLine(current, currentLength, &currentOffset, &lineLength);
+
+        bool changed = true;
+        if(row < instance->watchLines)
+        {
+            unsigned int previousLength;
+            unsigned int previousLine = watchNextLine(previous, instance->watchOutputLength, &previousOffset, &previousLength);
+            changed = (previousLength != lineLength) || memcmp(&previous[previousLine], &current[line], lineLength);
+        }
+
+        if(changed)
+        {
+            if(row < cursor)
+            {
+                batchPutCsi(&batch, cursor - row, 'A');
+            }
+            else if(row > cursor)
+            {
+                batchPutCsi(&batch, row - cursor, 'B');
+            }
+            batchPut(&batch, &current[line], lineLength);
+            batchPut(&batch, "\x1b[K\r\n", 5);
+            cursor = row + 1;
+        }
+        row++;
+    }
+
+    //back below the output, a shorter output clears the rows left over
+    if(row < cursor)
+    {
+        batchPutCsi(&batch, cursor - row, 'A');
+    }
+    else if(row > cursor)
+    {
+        batchPutCsi(&batch, row - cursor, 'B');
+    }
+    if(row < instance->watchLines)
+    {
+        batchPut(&batch, "\x1b[J", 3);
+    }
+    batchFlush(&batch);
+
+    instance->watchLines = row;
+    instance->watchOutputLength = currentLength;
+    instance->watchSwap = !instance->watchSwap;
+}
+
+static void watchStop(cliInstance_t * instance)
+{
+    instance->watchCommand = NULL;
+
+    //the prompt held back since the watch started
+    if(instance->promptMessage)
+    {
+        printOutput(instance, instance->promptMessage, strlen(instance->promptMessage));
+    }
+}
+#endif //CLI_ENABLE_WATCH
+
+#ifdef CLI_ENABLE_MACROS
+//macros are kept back to back in macroArena: cliMacro_t, the name, then the steps
+//each step is a cliMacroStep_t followed by its arguments (command path included)
+//every argument is prefixed by its parameter number, 0 for a literal, 1 - 9 for "$1" - "$9"
+typedef struct cliMacro_s
+{
+    unsigned int size;              //of the whole macro
+    unsigned int generation;        //s_cliCommandTreeGeneration the commands were resolved in
+    unsigned short numSteps;
+    unsigned char numParameters;
+}cliMacro_t;
+
+typedef struct cliMacroStep_s
+{
+    cliEntry_t * command;
+    unsigned short size;            //of the step including its arguments
+    unsigned char numArguments;
+    unsigned char depth;            //leading arguments naming the command
+    bool conditional;               //follows "&&", skipped if the previous command failed
+}cliMacroStep_t;
+
+#define CLI_MACRO_ALIGN(size) (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+//the arena is used from its first pointer aligned byte on
+static unsigned char * macroArena(cliInstance_t * instance, unsigned int * size)
+{
+    unsigned int padding = (sizeof(void *) - ((size_t) instance->macroArena % sizeof(void *))) % sizeof(void *);
+    *size = (instance->macroArenaSize > padding ? instance->macroArenaSize - padding : 0);
+    return &instance->macroArena[padding];
+}
+
+static cliMacro_t * macroFind(cliInstance_t * instance, const char * name)
+{
+    unsigned int size;
+    unsigned char * arena = macroArena(instance, &size);
+
+    for (unsigned int offset = 0; offset < instance->macroArenaUsed; offset += ((cliMacro_t *) &arena[offset])->size)
+    {
+        cliMacro_t * macro = (cliMacro_t *) &arena[offset];
+        if(strcmp((const char *) (macro + 1), name) == 0)
+        {
+            return macro;
+        }
+    }
+    return NULL;
+}
+
+static cliMacroStep_t * macroFirstStep(cliMacro_t * macro)
+{
+    return (cliMacroStep_t *) ((unsigned char *) macro + CLI_MACRO_ALIGN(sizeof(cliMacro_t) + strlen((const char *) (macro + 1)) + 1));
+}
+
+static void macroRemove(cliInstance_t * instance, cliMacro_t * macro)
+{
+    unsigned int size;
+    unsigned char * arena = macroArena(instance, &size);
+    unsigned int offset = (unsigned char *) macro - arena;
+    unsigned int macroSize = macro->size;
+
+    memmove(macro, (unsigned char *) macro + macroSize, instance->macroArenaUsed - offset - macroSize);
+    instance->macroArenaUsed -= macroSize;
+}
+
+//tokenizes and resolves the line once, the macro is appended behind the ones in use
+static int macroCompile(cliInstance_t * instance, const char * name, const char * text)
+{
+    unsigned int size;
+    unsigned char * arena = macroArena(instance, &size);
+    unsigned char * end = &arena[size];
+    unsigned int nameLength = strlen(name) + 1;
+    unsigned int length = strlen(text) + 1;
+
+    //the tokenizer works in place
+    char line[length];
+    memcpy(line, text, length);
+
+    cliMacro_t * macro = (cliMacro_t *) &arena[instance->macroArenaUsed];
+    unsigned char * position = (unsigned char *) macro + CLI_MACRO_ALIGN(sizeof(cliMacro_t) + nameLength);
+    if(position > end)
+    {
+        return CLI_STATUS_FAILURE;
+    }
+    macro->numSteps = 0;
+    macro->numParameters = 0;
+    memcpy(macro + 1, name, nameLength);
+
+    unsigned int offset = 0;
+    bool conditional = false;
+    while(offset < length)
+    {
+        unsigned int separatorLength;
+        bool nextConditional;
+        unsigned int commandEnd = findCommandEnd(line, offset, length, &separatorLength, &nextConditional);
+        if(commandEnd < length)
+        {
+            line[commandEnd] = '\0'; //terminate the command
+        }
+        else
+        {
+            commandEnd = length - 1; //line termination
+        }
+
+        unsigned int numArguments = getArguments(&line[offset], commandEnd - offset + 1, NULL);
+        if(numArguments)
+        {
+            char * argumentsVector[numArguments];
+            getArguments(&line[offset], commandEnd - offset + 1, argumentsVector);
+
+            unsigned int depth = 0;
+            cliEntry_t * command = resolveCommand(
+                prefixIndexGet(instance),
+                instance->commandLinkedListRoot,
+                numArguments,
+                argumentsVector,
+                &depth
+            );
+
+            if(command == NULL)
+            {
+                return CLI_STATUS_UNKNOWN_COMMAND;
+            }
+
+            cliMacroStep_t * step = (cliMacroStep_t *) position;
+            unsigned char * argument = (unsigned char *) (step + 1);
+            if( (numArguments > 255) || (argument > end) )
+            {
+                return CLI_STATUS_FAILURE;
+            }
+
+            for (unsigned int i = 0; i < numArguments; i++)
+            {
+                const char * value = argumentsVector[i];
+                unsigned int valueLength = strlen(value) + 1;
+                if(valueLength + 1 > (unsigned int) (end - argument))
+                {
+                    return CLI_STATUS_FAILURE;
+                }
+
+                unsigned char parameter = 0;
+                if( (i >= depth) && (value[0] == '$') && (value[1] >= '1') && (value[1] <= '9') && (value[2] == '\0') )
+                {
+                    parameter = value[1] - '0';
+                    macro->numParameters = (parameter > macro->numParameters ? parameter : macro->numParameters);
+                }
+
+                *argument++ = parameter;
+                memcpy(argument, value, valueLength);
+                argument += valueLength;
+            }
+
+            unsigned int stepSize = CLI_MACRO_ALIGN(argument - position);
+            if( (stepSize > (unsigned short) -1) || (macro->numSteps == (unsigned short) -1) )
+            {
+                return CLI_STATUS_FAILURE; //does not fit into the step or macro header
+            }
+
+            step->command = command;
+            step->size = stepSize;
+            step->numArguments = numArguments;
+            step->depth = depth;
+            step->conditional = conditional;
+            position += step->size;
+            macro->numSteps++;
+        }
+
+        conditional = nextConditional;
+        offset = commandEnd + separatorLength;
+    }
+
+    if(position > end)
+    {
+        return CLI_STATUS_FAILURE;
+    }
+
+    macro->size = position - (unsigned char *) macro;
+    macro->generation = s_cliCommandTreeGeneration;
+    instance->macroArenaUsed += macro->size;
+    return CLI_STATUS_SUCCESS;
+}
+
+//fills the first numArguments of the argument vector of a step, parameters are substituted without any parsing
+static void macroArguments(cliMacroStep_t * step, unsigned int numArguments, char ** argumentsVector, char ** parameters)
+{
+    char * argument = (char *) (step + 1);
+    for (unsigned int i = 0; i < numArguments; i++)
+    {
+        unsigned char parameter = *argument++;
+        argumentsVector[i] = (parameter ? parameters[parameter - 1] : argument);
+        argument += strlen(argument) + 1;
+    }
+}
+
+//the command tree changed since the macro got defined, the stored command paths are resolved again
+static bool macroResolve(cliInstance_t * instance, cliMacro_t * macro)
+{
+    cliMacroStep_t * step = macroFirstStep(macro);
+    for (unsigned int i = 0; i < macro->numSteps; i++)
+    {
+        //the command path never holds parameters
+        char * argumentsVector[step->depth];
+        macroArguments(step, step->depth, argumentsVector, NULL);
+
+        unsigned int depth = 0;
+        cliEntry_t * command = resolveCommand(
+            prefixIndexGet(instance),
+            instance->commandLinkedListRoot,
+            step->depth,
+            argumentsVector,
+            &depth
+        );
+
+        if( (command == NULL) || (depth != step->depth) )
+        {
+            return false;
+        }
+        step->command = command;
+        step = (cliMacroStep_t *) ((unsigned char *) step + step->size);
+    }
+
+    macro->generation = s_cliCommandTreeGeneration;
+    return true;
+}
+
+static int macroRun(cliInstance_t * instance, cliMacro_t * macro, unsigned int numParameters, char ** parameters)
+{
+    if(numParameters < macro->numParameters)
+    {
+        return CLI_STATUS_FAILURE;
+    }
+
+    if( (macro->generation != s_cliCommandTreeGeneration) && !macroResolve(instance, macro) )
+    {
+        return CLI_STATUS_UNKNOWN_COMMAND;
+    }
+
+    int status = CLI_STATUS_SUCCESS;
+    cliMacroStep_t * step = macroFirstStep(macro);
+    for (unsigned int i = 0; i < macro->numSteps; i++)
+    {
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+        if(instance->abortRequested)
+        {
+            return CLI_STATUS_FAILURE;
+        }
+#endif
+
+        if( !step->conditional || (status == CLI_STATUS_SUCCESS) )
+        {
+            char * argumentsVector[step->numArguments];
+            macroArguments(step, step->numArguments, argumentsVector, parameters);
+
+            status = executeCommand(
+                instance,
+                step->command,
+                step->numArguments - step->depth,
+                &argumentsVector[step->depth]
+            );
+        }
+        step = (cliMacroStep_t *) ((unsigned char *) step + step->size);
+    }
+    return status;
+}
+#endif //CLI_ENABLE_MACROS
+
+//handles one char of input, see cli_inputChar()
+static void processInputChar(cliInstance_t * instance, char inputChar)
+{
+#ifdef CLI_ENABLE_WATCH
+    //any key ends the watch, the key itself is consumed
+    if(instance->watchCommand)
+    {
+        watchStop(instance);
+        return;
+    }
+#endif
+
+#ifdef CLI_ENABLE_LINE_EDITOR
+    if(editorInputChar(instance, inputChar))
+    {
+        return;
+    }
+#endif
+
+    switch (inputChar)
+    {
+        //Check if Return got hit
+        case '\n':
+        case '\r':
+        {
+            instance->actionPending = true;
+        } break;
+
+        case '\t':
+        {
+#ifdef CLI_ENABLE_LINE_EDITOR
+            //only the end of the line gets completed
+            if(!instance->actionPending && (instance->cursorPosition == instance->inputBufferFilledSize))
+            {
+                completeInput(instance);
+                instance->cursorPosition = instance->inputBufferFilledSize;
+            }
+#else
+            if(!instance->actionPending)
+            {
+                completeInput(instance);
+            }
+#endif
+        }
+        break;
+
+        case '\b':
+        {
+            if(!instance->actionPending && instance->inputBufferFilledSize)
+            {
+                instance->inputBufferFilledSize--;
+
+                if(instance->localEcho)
+                {
+                    printOutput(instance, "\b \b", 3);
+                }
+            }
+        }
+        break;
+
+        default:
+        {
+            if(!instance->actionPending && (instance->inputBufferFilledSize < (instance->inputBufferMaxSize - 1))) //always needs space for trailing \0
+            {
+                instance->inputBuffer[instance->inputBufferFilledSize++] = inputChar;
+                
+                if(instance->localEcho)
+                {
+                    printOutput(instance, &inputChar, 1);
+                }
+            }
+        } break;
+    }
+}
+
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+static cliPriorityEntry_t * priorityFind(cliInstance_t * instance, char key)
+{
+    for (unsigned int i = 0; i < instance->numPriorityCommands; i++)
+    {
+        if(instance->priorityCommands[i].key == key)
+        {
+            return &instance->priorityCommands[i];
+        }
+    }
+    return NULL;
+}
+
+//handles inputChar if it is a priority key, interrupt safe as long as the entry functions are
+//only flags get set, the input buffer belongs to the main context
+static bool priorityInput(cliInstance_t * instance, char inputChar)
+{
+    cliPriorityEntry_t * entry = priorityFind(instance, inputChar);
+    if(entry)
+    {
+        entry->hits++;
+        if(entry->abort)
+        {
+            if(instance->actionPending)
+            {
+                //the running command may poll cli_abortRequested(), the rest of the line is dropped
+                instance->abortRequested = true;
+            }
+            else
+            {
+                //nothing running, the next tick drops the typed input (or a watch) for a fresh prompt
+                instance->discardRequested = true;
+            }
+        }
+
+        if(entry->function)
+        {
+            entry->function(instance);
+        }
+    }
+    return (entry != NULL);
+}
+#endif //CLI_ENABLE_PRIORITY_COMMANDS
+
+//runs up to maxCommands commands of the pending line: "cmd1 ; cmd2 && cmd3"
+//"&&" skips the following command if the previous one failed
+//the line stays pending until its last command ran, returns the number of commands run
+static unsigned int dispatchLine(cliInstance_t * instance, unsigned int maxCommands)
+{
+    if(!instance->dispatchStarted)
+    {
+#ifdef CLI_ENABLE_HISTORY
+        historyAdd(instance, instance->inputBuffer, instance->inputBufferFilledSize);
+#endif
+
+        //add a string termination for the argument parser
+        instance->inputBuffer[instance->inputBufferFilledSize++] = '\0';
+
+        instance->dispatchOffset = 0;
+        instance->dispatchSkip = false;
+        instance->dispatchEchoed = false;
+        instance->dispatchStarted = true;
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+        //cleared here rather than at the end, an abort racing with the end of the previous line can't hit this one
+        instance->abortRequested = false;
+#endif
+    }
+
+    char * line = instance->inputBuffer;
+    unsigned int length = instance->inputBufferFilledSize;
+    unsigned int dispatched = 0;
+
+    while( (instance->dispatchOffset < length) && (dispatched < maxCommands) )
+    {
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+        if(instance->abortRequested)
+        {
+            instance->dispatchOffset = length; //the rest of the line is dropped
+            break;
+        }
+#endif
+
+        unsigned int offset = instance->dispatchOffset;
+        unsigned int separatorLength;
+        bool conditional;
+        unsigned int end = findCommandEnd(line, offset, length, &separatorLength, &conditional);
+        if(end < length)
+        {
+            line[end] = '\0'; //terminate the command
+        }
+        else
+        {
+            end = length - 1; //line termination
+        }
+
+        //empty commands ("a ; ; b", a blank line) keep the last status
+        if(!instance->dispatchSkip && dispatchCommand(instance, &line[offset], end - offset + 1, &instance->dispatchEchoed, &instance->lastStatus))
+        {
+            dispatched++;
+        }
+        instance->dispatchSkip = conditional && (instance->lastStatus != CLI_STATUS_SUCCESS);
+
+        instance->dispatchOffset = end + separatorLength;
+    }
+
+    if(instance->dispatchOffset < length)
+    {
+        return dispatched; //continued on the next tick
+    }
+
+    //reset Buffer
+    instance->inputBufferFilledSize = 0;
+#ifdef CLI_ENABLE_LINE_EDITOR
+    instance->cursorPosition = 0;
+#endif
+    instance->dispatchStarted = false;
+    instance->actionPending = false;
+
+#ifdef CLI_ENABLE_WATCH
+    //the watch takes over the screen below, the prompt follows once it ends
+    if(instance->watchCommand)
+    {
+        return dispatched;
+    }
+#endif
+
+    if(instance->promptMessage)
+    {
+        printOutput(instance, instance->promptMessage, strlen(instance->promptMessage));
+    }
+    return dispatched;
+}
+
+//see cli_tickLimited()
+static unsigned int tickLimited(cliInstance_t * instance, unsigned int maxCommands)
+{
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+    if(instance->discardRequested)
+    {
+        //abort key while idle: the typed input (or a watch) is dropped for a fresh prompt, whatever maxCommands is
+        instance->discardRequested = false;
+#ifdef CLI_ENABLE_WATCH
+        instance->watchCommand = NULL;
+#endif
+        instance->inputBufferFilledSize = 0;
+#ifdef CLI_ENABLE_LINE_EDITOR
+        instance->cursorPosition = 0;
+#endif
+#ifdef CLI_ENABLE_HISTORY
+        instance->historySearching = false;
+        instance->historyRecall = 0;
+#endif
+        instance->dispatchStarted = false;
+        instance->actionPending = false;
+
+        if(instance->promptMessage)
+        {
+            printOutput(instance, instance->promptMessage, strlen(instance->promptMessage));
+        }
+    }
+#endif
+
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+    //backpressure, a new command only runs once the consumer took the previous output
+    if(instance->outputQueueBuffer && flushOutput(instance))
+    {
+        return 0;
+    }
+#endif
+
+#ifdef CLI_ENABLE_WATCH
+    if(instance->watchCommand && !instance->actionPending)
+    {
+        unsigned int now = instance->timeFunction();
+        if(now - instance->watchTimestamp >= instance->watchInterval)
+        {
+            instance->watchTimestamp = now;
+            watchRun(instance);
+        }
+    }
+#endif
+
+    //check if there is data to be parsed
+    if(instance->actionPending)
+    {
+        return dispatchLine(instance, maxCommands);
+    }
+    return 0;
+}
+
+#endif// INTERNAL STATIC SECTION
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+unsigned int cli_print(cliInstance_t * instance, const char * buffer, unsigned int len)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(buffer || !len);
+
+    return printOutput(instance, buffer, len);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+unsigned int cli_flushOutput(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    return (instance->outputQueueBuffer ? flushOutput(instance) : 0);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+unsigned int cli_outputSpace(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    if(instance->outputQueueBuffer == NULL)
+    {
+        return (unsigned int) -1; //printFunction takes everything (or blocks)
+    }
+    return instance->outputQueueSize - instance->outputQueueUsed;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#endif //CLI_ENABLE_OUTPUT_QUEUE
+
+
+#ifdef CLI_ENABLE_SCRATCH_ARENA
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void * cli_scratchAlloc(cliInstance_t * instance, unsigned int size)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    //bump allocation, returns NULL once the arena is exhausted
+    unsigned int used = instance->scratchArenaUsed;
+    unsigned int misalignment = (size_t) &instance->scratchArena[used] % CLI_SCRATCH_ALIGNMENT;
+    if(misalignment)
+    {
+        used += CLI_SCRATCH_ALIGNMENT - misalignment;
+    }
+
+    if( (instance->scratchArena == NULL) || (used > instance->scratchArenaSize) || (size > instance->scratchArenaSize - used) )
+    {
+        return NULL;
+    }
+
+    instance->scratchArenaUsed = used + size;
+    return &instance->scratchArena[used];
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#endif //CLI_ENABLE_SCRATCH_ARENA
+
+
+#ifdef CLI_ENABLE_OUTPUT_CACHE
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_invalidateOutputCache(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    //all slots captured in an older epoch are stale now
+    instance->outputCacheEpoch++;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#endif //CLI_ENABLE_OUTPUT_CACHE
+
+
+#ifdef CLI_ENABLE_RECORDING
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_startRecording(cliInstance_t * instance, cliPrint_func recordFunction)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(recordFunction);
+
+    //everything from now on goes to recordFunction, starting with the header
+    //time deltas need timeFunction, they are 0 without one
+    recordFunction(CLI_RECORD_MAGIC, CLI_RECORD_MAGIC_SIZE);
+    instance->recordTimestamp = (instance->timeFunction ? instance->timeFunction() : 0);
+    instance->recordFunction = recordFunction;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_stopRecording(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    instance->recordFunction = NULL;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#endif //CLI_ENABLE_RECORDING
+
+
+#ifdef CLI_ENABLE_STRUCTURED_OUTPUT
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_setOutputFormat(cliInstance_t * instance, cliOutputFormat_t format)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    instance->outputFormat = format;
+#ifdef CLI_ENABLE_OUTPUT_CACHE
+    //cached output was rendered in the previous format
+    instance->outputCacheEpoch++;
+#endif
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitObjectBegin(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    emitBegin(instance, '{', CLI_TLV_OBJECT_BEGIN);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitObjectEnd(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    emitEnd(instance, '}', CLI_TLV_OBJECT_END);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitArrayBegin(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    emitBegin(instance, '[', CLI_TLV_ARRAY_BEGIN);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitArrayEnd(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    emitEnd(instance, ']', CLI_TLV_ARRAY_END);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitKey(cliInstance_t * instance, const char * key)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(key);
+
+    //names the following value, only valid inside an object
+    emitKey(instance, key);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitInt(cliInstance_t * instance, int value)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    unsigned int magnitude = (value < 0 ? 0u - (unsigned int) value : (unsigned int) value);
+    emitNumber(instance, magnitude, (value < 0), CLI_TLV_INT);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitUnsigned(cliInstance_t * instance, unsigned int value)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    emitNumber(instance, value, false, CLI_TLV_UNSIGNED);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitString(cliInstance_t * instance, const char * str)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(str);
+
+    emitString(instance, str);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitByteArray(cliInstance_t * instance, const unsigned char * bytes, unsigned int length)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(bytes || (length == 0));
+
+    emitByteArray(instance, bytes, length);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitBool(cliInstance_t * instance, bool value)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    emitBool(instance, value);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_emitFloat(cliInstance_t * instance, float value)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    emitFloat(instance, value);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+#endif //CLI_ENABLE_FLOAT_ARGUMENTS
+
+#endif //CLI_ENABLE_STRUCTURED_OUTPUT
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+void cli_inputChar(cliInstance_t * instance, char inputChar)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+
+    CLI_ASSERT(instance);
+
+#ifdef CLI_ENABLE_RECORDING
+    recordData(instance, CLI_RECORD_INPUT, &inputChar, 1);
+#endif
+
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+    if(priorityInput(instance, inputChar))
+    {
+        return;
+    }
+#endif
+
+    processInputChar(instance, inputChar);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+unsigned int cli_inputChars(cliInstance_t * instance, const char * chars, unsigned int length)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(chars || (length == 0));
+
+    //bulk input, stops right behind a completed line so it can be executed by cli_tick()
+    //returns the number of consumed chars, 0 while the previous line is still pending
+    unsigned int consumed = 0;
+
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+    //priority keys right at the start still get through
+    while( (consumed < length) && instance->actionPending && priorityFind(instance, chars[consumed]) )
+    {
+#ifdef CLI_ENABLE_RECORDING
+        recordData(instance, CLI_RECORD_INPUT, &chars[consumed], 1);
+#endif
+        priorityInput(instance, chars[consumed++]);
+    }
+
+    //input behind an abort waits for the fresh prompt of the next tick
+    while( (consumed < length) && !instance->actionPending && !instance->discardRequested )
+#else
+    while( (consumed < length) && !instance->actionPending )
+#endif
+    {
+        //only a line end can complete the line, which bounds the input to record up front
+        unsigned int end = consumed;
+        while( (end < length) && (chars[end] != '\r') && (chars[end] != '\n') )
+        {
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+            if(priorityFind(instance, chars[end]))
+            {
+                break; //an abort completes the line as well
+            }
+#endif
+            end++;
+        }
+        end += (end < length);
+
+#ifdef CLI_ENABLE_RECORDING
+        recordData(instance, CLI_RECORD_INPUT, &chars[consumed], end - consumed);
+#endif
+        while( (consumed < end) && !instance->actionPending )
+        {
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+            if(priorityInput(instance, chars[consumed]))
+            {
+                consumed++;
+                continue;
+            }
+#endif
+            processInputChar(instance, chars[consumed++]);
+        }
+    }
+    return consumed;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+bool cli_priorityInput(cliInstance_t * instance, char inputChar)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    //handles inputChar only if it is one of the priorityCommands, returns false for any other input
+    //unlike cli_inputChar() nothing is recorded or echoed, safe to call from an interrupt or signal handler
+    //as long as the entry functions are: only flags get set, the next cli_tick() does the rest
+    return priorityInput(instance, inputChar);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+bool cli_abortRequested(const cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    //polled by long running commands, true once an abort key got hit while the line was pending
+    //stays set until the next line starts
+    return instance->abortRequested;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#endif //CLI_ENABLE_PRIORITY_COMMANDS
+
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+void cli_tick(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    tickLimited(instance, (unsigned int) -1);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+unsigned int cli_tickLimited(cliInstance_t * instance, unsigned int maxCommands)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    //like cli_tick(), but runs at most maxCommands commands of a "cmd1 ; cmd2" line
+    //the rest of the line stays pending for the following calls, returns the number of commands run
+    return tickLimited(instance, maxCommands);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+unsigned int cli_pendingCommands(const cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    //queue depth: commands of the pending line which did not run yet (skipped ones included)
+    if(!instance->actionPending)
+    {
+        return 0;
+    }
+
+    const char * line = instance->inputBuffer;
+    unsigned int length = instance->inputBufferFilledSize;
+    unsigned int offset = (instance->dispatchStarted ? instance->dispatchOffset : 0);
+    unsigned int pending = 0;
+
+    while(offset < length)
+    {
+        unsigned int separatorLength;
+        bool conditional;
+        offset = findCommandEnd(line, offset, length, &separatorLength, &conditional) + separatorLength;
+        pending++;
+    }
+    return pending;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_ENABLE_SCHEDULER
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+unsigned int cli_schedulerTick(cliScheduler_t * scheduler)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(scheduler);
+    CLI_ASSERT(scheduler->slots || (scheduler->numSlots == 0));
+    CLI_ASSERT(scheduler->numSlots <= 32);
+    CLI_ASSERT(scheduler->timeFunction || (scheduler->timeBudget == 0));
+
+    //replaces calling cli_tick() on every instance
+    //returns the number of commands run, readySet tells if there is more to do right away
+    unsigned int start = (scheduler->timeFunction ? scheduler->timeFunction() : 0);
+    unsigned int executed = 0;
+    unsigned int ready = 0;
+
+    //ready set: instances with a completed line, the others only get their queued output flushed
+    for (unsigned int i = 0; i < scheduler->numSlots; i++)
+    {
+        cliSchedulerSlot_t * slot = &scheduler->slots[i];
+        slot->tickCommands = 0;
+        if(slot->instance->actionPending)
+        {
+            ready |= (1u << i);
+        }
+        else
+        {
+            tickLimited(slot->instance, 0);
+        }
+    }
+
+    //one command per ready instance and turn, until everything ran or a budget is used up
+    unsigned int index = (scheduler->nextSlot < scheduler->numSlots ? scheduler->nextSlot : 0);
+    while(ready)
+    {
+        if( (scheduler->commandBudget && (executed >= scheduler->commandBudget)) ||
+            (scheduler->timeBudget && (scheduler->timeFunction() - start >= scheduler->timeBudget)) )
+        {
+            break;
+        }
+
+        if(ready & (1u << index))
+        {
+            cliSchedulerSlot_t * slot = &scheduler->slots[index];
+            unsigned int count = tickLimited(slot->instance, 1);
+            executed += count;
+            slot->tickCommands += count;
+            slot->executedCommands += count;
+
+            //done, blocked by its output queue or out of its own budget
+            if( !slot->instance->actionPending || (count == 0) ||
+                (slot->commandBudget && (slot->tickCommands >= slot->commandBudget)) )
+            {
+                ready &= ~(1u << index);
+            }
+
+            //the next tick continues behind the last served instance
+            scheduler->nextSlot = index + 1;
+        }
+
+        index = (index + 1 < scheduler->numSlots ? index + 1 : 0);
+    }
+
+    //metrics
+    scheduler->readySet = 0;
+    for (unsigned int i = 0; i < scheduler->numSlots; i++)
+    {
+        cliSchedulerSlot_t * slot = &scheduler->slots[i];
+        slot->pendingCommands = cli_pendingCommands(slot->instance);
+        if(slot->instance->actionPending)
+        {
+            scheduler->readySet |= (1u << i);
+            slot->deferredTicks++;
+        }
+        if(slot->pendingCommands > slot->maxPendingCommands)
+        {
+            slot->maxPendingCommands = slot->pendingCommands;
+        }
+#ifdef CLI_ENABLE_OUTPUT_QUEUE
+        if(slot->instance->outputQueueUsed > slot->maxQueuedOutput)
+        {
+            slot->maxQueuedOutput = slot->instance->outputQueueUsed;
+        }
+#endif
+    }
+
+    return executed;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#endif //CLI_ENABLE_SCHEDULER
+
+
+#ifdef CLI_ENABLE_WATCH
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+int cli_watch(cliInstance_t * instance, unsigned int interval, int argc, char const *argv[])
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(argv || (argc == 0));
+
+    //reruns the command given by argv every interval ms from cli_tick() until any key is hit
+    //only the rows of its output which changed get redrawn, needs timeFunction and watchBuffer
+    //the command is resolved once, returns CLI_STATUS_SUCCESS once the watch started
+    if( (argc == 0) || !instance->timeFunction || !instance->watchBuffer || instance->watchCommand )
+    {
+        return CLI_STATUS_FAILURE;
+    }
+
+    unsigned int depth = 0;
+    cliEntry_t * command = resolveCommand(
+        prefixIndexGet(instance),
+        instance->commandLinkedListRoot,
+        argc,
+        (char **) argv,
+        &depth
+    );
+
+    if(command == NULL)
+    {
+        return CLI_STATUS_UNKNOWN_COMMAND;
+    }
+
+    //keep at least half of the buffer for the output
+    unsigned int length = 0;
+    for (int i = depth; i < argc; i++)
+    {
+        unsigned int argumentLength = strlen(argv[i]) + 1;
+        if(length + argumentLength > instance->watchBufferSize / 2)
+        {
+            return CLI_STATUS_FAILURE;
+        }
+        memcpy(&instance->watchBuffer[length], argv[i], argumentLength);
+        length += argumentLength;
+    }
+
+    instance->watchArgc = argc - depth;
+    instance->watchArgumentsLength = length;
+    instance->watchOutputLength = 0;
+    instance->watchLines = 0;
+    instance->watchSwap = false;
+    instance->watchInterval = interval;
+    instance->watchTimestamp = instance->timeFunction() - interval; //first run on the next tick
+    instance->watchCommand = command;
+    return CLI_STATUS_SUCCESS;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+void cli_watchStop(cliInstance_t * instance)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+
+    if(instance->watchCommand)
+    {
+        watchStop(instance);
+    }
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+#endif //CLI_ENABLE_WATCH
+
+
+#ifdef CLI_ENABLE_MACROS
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+int cli_macroDefine(cliInstance_t * instance, const char * name, const char * line)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(instance);
+    CLI_ASSERT(name);
+    CLI_ASSERT(line);
+
+    //stores the commands of line ("cmd1 $1 ; cmd2 && cmd3") resolved and tokenized in macroArena
+    //arguments "$1" - "$9" get replaced by the parameters of cli_macroRun()
+    //an existing macro of the same name is only replaced once the new one fits
+    if( (name[0] == '\0') || instance->macroNesting )
+    {
+        return CLI_STATUS_FAILURE;
+    }
+
+    cliMacro_t * previous = macroFind(instance, name);
+    int status = macroCompile(instance, name, line);
+    if( (status == CLI_STATUS_SUCCESS) && previous )
+    {
+        macroRemove(instance, previous);
+    }
+    return status;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
 
 #ifdef CLI_INLINE_IMPLEMENTATION
 inline
@@ -222,138 +4724,70 @@ inline
 #ifdef CLI_STATIC_IMPLEMENTATION
 static
 #endif 
-void cli_inputChar(cliInstance_t * instance, char inputChar)
+int cli_macroRun(cliInstance_t * instance, const char * name, int argc, char const *argv[])
 #ifdef CLI_ONLY_PROTOTYPE_DECLARATION
 ;
 #else
 {
-
     CLI_ASSERT(instance);
+    CLI_ASSERT(name);
+    CLI_ASSERT(argv || (argc == 0));
 
-    switch (inputChar)
+    //runs the stored commands with argv as the parameters, "&&" works like on the command line
+    //returns the status of the last command run
+    cliMacro_t * macro = macroFind(instance, name);
+    if(macro == NULL)
     {
-        //Check if Return got hit
-        case '\n':
-        case '\r':
-        {
-            instance->actionPending = true;
-        } break;
-
-        case '\b':
-        {
-            if(instance->inputBufferFilledSize)
-            {
-                instance->inputBufferFilledSize--;
+        return CLI_STATUS_UNKNOWN_COMMAND;
+    }
 
-                if(instance->localEcho)
-                {
-                    instance->printFunction("\b \b", 3);
-                }
-            }
-        }
-        break;
+    if(instance->macroNesting >= CLI_MACRO_MAX_NESTING)
+    {
+        return CLI_STATUS_FAILURE;
+    }
 
-        default:
-        {
-            if(!instance->actionPending && (instance->inputBufferFilledSize < (instance->inputBufferMaxSize - 1))) //always needs space for trailing \0
-            {
-                instance->inputBuffer[instance->inputBufferFilledSize++] = inputChar;
-                
-                if(instance->localEcho)
-                {
-                    instance->printFunction(&inputChar, 1);
-                }
-            }
-        } break;
+#ifdef CLI_ENABLE_PRIORITY_COMMANDS
+    if(!instance->dispatchStarted)
+    {
+        instance->abortRequested = false; //left from an aborted line, this run is not part of one
     }
+#endif
+
+    instance->macroNesting++;
+    int status = macroRun(instance, macro, argc, (char **) argv);
+    instance->macroNesting--;
+    return status;
 }
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
 
 
-
 #ifdef CLI_INLINE_IMPLEMENTATION
 inline
 #endif 
 #ifdef CLI_STATIC_IMPLEMENTATION
 static
 #endif 
-void cli_tick(cliInstance_t * instance)
+bool cli_macroDelete(cliInstance_t * instance, const char * name)
 #ifdef CLI_ONLY_PROTOTYPE_DECLARATION
 ;
 #else
 {
     CLI_ASSERT(instance);
+    CLI_ASSERT(name);
 
-    //check if there is data to be parsed
-    if(instance->actionPending)
+    cliMacro_t * macro = macroFind(instance, name);
+    if( (macro == NULL) || instance->macroNesting )
     {
-        //add a string termination for the argument parser
-        instance->inputBuffer[instance->inputBufferFilledSize++] = '\0';
-        
-        //check the amount of Arguments
-        unsigned int numArguments = getArguments(
-            instance->inputBuffer, 
-            instance->inputBufferFilledSize, 
-            NULL
-        );
-
-        //alloc Argument array in Stack
-        char * argumentsVector[numArguments];
-        //fill Argument Array
-        getArguments(
-            instance->inputBuffer,
-            instance->inputBufferFilledSize, 
-            argumentsVector
-        );
-
-        //loop through the command linked list till one or none matches
-        cliEntry_t * command = instance->commandLinkedListRoot;
-        while(command)
-        {
-            int commandLength = strlen(command->commandCallName);
-
-            
-            //Argument 0 holds the given command call
-            if(
-                (instance->inputBufferFilledSize >= commandLength)
-                && (memcmp(argumentsVector[0], command->commandCallName, commandLength) == 0)
-            )
-            {
-                //Found Matching Command
-                
-                if(instance->localEcho)
-                {
-                    //Lr-Cr before exec
-                    instance->printFunction("\n\r",2);
-                } 
-                
-                //Exec Command
-                command->execFunction(
-                    (numArguments-1), //command Call-Name is not needed inside the Handler
-                    (numArguments > 1 ? (const char **) &argumentsVector[1] : NULL), 
-                    instance->printFunction
-                );
-                command = NULL;
-            }
-            else
-            {
-                //Go to next Command in list
-                command = (command->next != command ? command->next : NULL);
-            }
-        }
-
-        //reset Buffer
-        instance->inputBufferFilledSize = 0;
-        instance->actionPending = false;
-
-        if(instance->promptMessage)
-        {
-            instance->printFunction(instance->promptMessage, strlen(instance->promptMessage));
-        }
+        return false;
     }
+
+    macroRemove(instance, macro);
+    return true;
 }
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
 
+#endif //CLI_ENABLE_MACROS
+
 
 
 #ifdef CLI_INLINE_IMPLEMENTATION
@@ -370,6 +4804,10 @@ void cli_clear(cliInstance_t * instance)
     CLI_ASSERT(instance);
 
     instance->inputBufferFilledSize = 0;
+#ifdef CLI_ENABLE_LINE_EDITOR
+    instance->cursorPosition = 0;
+#endif
+    instance->dispatchStarted = false;
     instance->actionPending = true;
 }
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
@@ -389,25 +4827,7 @@ void cli_addCommand(cliInstance_t * instance, cliEntry_t * command)
     CLI_ASSERT(instance);
     CLI_ASSERT(command);
 
-    cliEntry_t * lastCommand = instance->commandLinkedListRoot;
-
-    if(lastCommand == NULL)
-    {
-            instance->commandLinkedListRoot = command;
-    }
-    else
-    {
-        //find last command of linked List
-        while ( ( lastCommand->next != lastCommand ) && (lastCommand->next != NULL) )
-        {
-            lastCommand = lastCommand->next;
-        }
-        //Append command to linked List
-        lastCommand->next = command;
-    }
-
-    //mark command as new end of linked List
-    command->next = command;
+    linkedListAppend(&instance->commandLinkedListRoot, command);
 }
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
 
@@ -427,42 +4847,45 @@ void cli_removeCommand(cliInstance_t * instance, cliEntry_t *command)
     CLI_ASSERT(command);
 
 
-    //check if there is something to remove
-    if(instance->commandLinkedListRoot == NULL)
-    {
-        return;
-    }
+    linkedListRemove(&instance->commandLinkedListRoot, command);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
 
-    //check if the command to be removed is the current root command
-    if (instance->commandLinkedListRoot == command)
-    {
-        //check if command is the only command in linked List
-        if(command->next == command)
-        {
-            //mark Instance as empty
-            instance->commandLinkedListRoot = NULL;   
-        }
-        else
-        {
-            //make the next command the new root command
-            instance->commandLinkedListRoot = command->next;   
-        }
-    }
-    else
-    {
-        //find previous Entry in Linked List
-        cliEntry_t * previousEntry = instance->commandLinkedListRoot;
-        while ( previousEntry->next != command)
-        {
-            previousEntry = previousEntry->next;
-        }
-        
-        //remove command from linked List
-        previousEntry->next = command->next;
-    }
 
-    //Mark Command as not at part of a linked List 
-    command->next = NULL; 
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_addSubCommand(cliEntry_t * parent, cliEntry_t * command)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(parent);
+    CLI_ASSERT(command);
+
+    linkedListAppend(&parent->subCommandLinkedListRoot, command);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+
+
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif
+void cli_removeSubCommand(cliEntry_t * parent, cliEntry_t * command)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(parent);
+    CLI_ASSERT(command);
+
+    linkedListRemove(&parent->subCommandLinkedListRoot, command);
 }
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
 
@@ -520,6 +4943,21 @@ cliArgumentType_t cli_classifyArgumentType(const char * arg)
         return CLI_ARGUMENT_DEC_UINT;
     }
 
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+    //[+-]digits[.digits][e[+-]digits], a fraction or an exponent is required to tell it from an integer
+    if(strpbrk(arg, ".eE"))
+    {
+        uint64_t mantissa;
+        int exponent;
+        bool truncated;
+        bool negative;
+        if(parseDecimal(arg, CLI_FLOAT_FAST_DIGITS, &mantissa, NULL, &exponent, &truncated, &negative))
+        {
+            return CLI_ARGUMENT_FLOAT;
+        }
+    }
+#endif
+
     return CLI_ARGUMENT_UNDEFINED;
 }
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
@@ -609,6 +5047,28 @@ void    cli_putUnsignedDecimal(cliPrint_func output, unsigned int num)
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
 
 
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+void    cli_putFloat(cliPrint_func output, float num)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(output);
+
+    char buffer[CLI_FLOAT_STRING_SIZE];
+    unsigned int len = formatFloat(buffer, num);
+    output(buffer, len);
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+#endif //CLI_ENABLE_FLOAT_ARGUMENTS
+
+
 #ifdef CLI_INLINE_IMPLEMENTATION
 inline
 #endif 
@@ -674,6 +5134,30 @@ int cli_getSignedDecimal(const char * arg)
 #endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
 
 
+#ifdef CLI_ENABLE_FLOAT_ARGUMENTS
+#ifdef CLI_INLINE_IMPLEMENTATION
+inline
+#endif 
+#ifdef CLI_STATIC_IMPLEMENTATION
+static
+#endif 
+float cli_getFloat(const char * arg)
+#ifdef CLI_ONLY_PROTOTYPE_DECLARATION
+;
+#else
+{
+    CLI_ASSERT(arg);
+
+    //correctly rounded (nearest, ties to even), locale independent
+    //returns 0 for anything cli_classifyArgumentType does not report as float or integer
+    float result = 0;
+    parseFloat(arg, &result);
+    return result;
+}
+#endif // NOT(CLI_ONLY_PROTOTYPE_DECLARATION)
+#endif //CLI_ENABLE_FLOAT_ARGUMENTS
+
+
 
 
 #ifdef CLI_INLINE_IMPLEMENTATION
@@ -739,34 +5223,176 @@ unsigned  int  cli_getByteArrayElements(const char * arg, unsigned char * buffer
 #if !defined(CLI_ONLY_PROTOTYPE_DECLARATION) && defined(CLI_IMPLEMENT_HELP_FUNC_COMMAND)
 /*--------------------------------------DEFAULT COMMAND--------------------------------------------------*/
 /*-----------------------------THIS SHOULD BE LINKED LIST ROOT-------------------------------------------*/
-static void printHelp(int argc, char const *argv[], cliPrint_func outputFunc);
+static int printHelp(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc);
 //Must be root Entry to work properly
 cliEntry_t rootHelpEntry =
 {
     .commandCallName = "help",
-    .execFunction = printHelp,
+    .execFunctionEx = printHelp,
     .next = NULL
 };
-static void printHelp(int argc, char const *argv[], cliPrint_func outputFunc)
+static int printHelp(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
 {
-    cliEntry_t * entry = rootHelpEntry.next;
-    while (entry)
+    cliEntry_t * level = rootHelpEntry.next;
+
+    //"help <group> <subgroup>" lists one level of the command tree at a time
+    if(argc)
     {
-        if(entry->commandHelpText)
+        unsigned int depth = 0;
+        cliEntry_t * group = resolveCommand(NULL, rootHelpEntry.next, argc, (char **) argv, &depth);
+        if( (group == NULL) || (depth != (unsigned int) argc) )
         {
-            //Command
-            outputFunc("[",1);
-            outputFunc(entry->commandCallName,strlen(entry->commandCallName));
-            outputFunc("]",1);
-            outputFunc("\r\n", 2);
-            //Help text
-            outputFunc(entry->commandHelpText,strlen(entry->commandHelpText));
-            outputFunc("\r\n", 2);
-            outputFunc("\r\n", 2);
+            outputFunc("unknown command", 15);
+            return CLI_STATUS_UNKNOWN_COMMAND;
         }
+        level = group->subCommandLinkedListRoot;
+    }
 
-        //Goto next command
-        entry = ( entry->next != entry ? entry->next : NULL );
-    } 
+    printCommandList(instance, level, outputFunc);
+    return CLI_STATUS_SUCCESS;
+}
+#endif
+
+
+
+#if !defined(CLI_ONLY_PROTOTYPE_DECLARATION) && defined(CLI_IMPLEMENT_WATCH_COMMAND)
+/*--------------------------------------WATCH COMMAND----------------------------------------------------*/
+static int watchCommandFunction(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc);
+//"watch <interval ms> <command ...>", add it with cli_addCommand()
+cliEntry_t watchCommandEntry =
+{
+    .commandCallName = "watch",
+    .commandHelpText = "reruns a command every <interval ms> and redraws what changed, any key stops it",
+    .execFunctionEx = watchCommandFunction,
+    .next = NULL
+};
+static int watchCommandFunction(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if( (argc < 2) || (cli_classifyArgumentType(argv[0]) != CLI_ARGUMENT_DEC_UINT) )
+    {
+        outputFunc("usage: watch <interval ms> <command ...>", 40);
+        return CLI_STATUS_FAILURE;
+    }
+
+    return cli_watch(instance, cli_getUnsignedDecimal(argv[0]), argc - 1, &argv[1]);
+}
+#endif
+
+
+
+#if !defined(CLI_ONLY_PROTOTYPE_DECLARATION) && defined(CLI_IMPLEMENT_MACRO_COMMAND)
+/*--------------------------------------MACRO COMMAND----------------------------------------------------*/
+//"macro define|run|delete|list ...", add macroCommandEntry with cli_addCommand()
+static int macroDefineFunction(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(argc < 2)
+    {
+        outputFunc("usage: macro define <name> \"<command> [$1..$9] ; <command> && ...\"", 66);
+        return CLI_STATUS_FAILURE;
+    }
+
+    //the commands may also be given unquoted as the remaining arguments
+    unsigned int length = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        length += strlen(argv[i]) + 1;
+    }
+    char line[length];
+    length = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        unsigned int argumentLength = strlen(argv[i]);
+        memcpy(&line[length], argv[i], argumentLength);
+        length += argumentLength;
+        line[length++] = ' ';
+    }
+    line[length - 1] = '\0';
+
+    int status = cli_macroDefine(instance, argv[0], line);
+    if(status == CLI_STATUS_UNKNOWN_COMMAND)
+    {
+        outputFunc("unknown command in macro", 24);
+    }
+    else if(status != CLI_STATUS_SUCCESS)
+    {
+        outputFunc("macro does not fit", 18);
+    }
+    return status;
+}
+
+static int macroRunFunction(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(argc < 1)
+    {
+        outputFunc("usage: macro run <name> [parameters ...]", 40);
+        return CLI_STATUS_FAILURE;
+    }
+
+    return cli_macroRun(instance, argv[0], argc - 1, &argv[1]);
+}
+
+static int macroDeleteFunction(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if( (argc != 1) || !cli_macroDelete(instance, argv[0]) )
+    {
+        return CLI_STATUS_FAILURE;
+    }
+    return CLI_STATUS_SUCCESS;
+}
+
+static int macroListFunction(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    unsigned int size;
+    unsigned char * arena = macroArena(instance, &size);
+
+    for (unsigned int offset = 0; offset < instance->macroArenaUsed; offset += ((cliMacro_t *) &arena[offset])->size)
+    {
+        cliMacro_t * macro = (cliMacro_t *) &arena[offset];
+        const char * name = (const char *) (macro + 1);
+        outputFunc(name, strlen(name));
+        outputFunc(": ", 2);
+        cli_putUnsignedDecimal(outputFunc, macro->numSteps);
+        outputFunc(" commands, ", 11);
+        cli_putUnsignedDecimal(outputFunc, macro->numParameters);
+        outputFunc(" parameters\n\r", 13);
+    }
+    return CLI_STATUS_SUCCESS;
 }
+
+cliEntry_t macroListEntry =
+{
+    .commandCallName = "list",
+    .commandHelpText = "lists the defined macros",
+    .execFunctionEx = macroListFunction,
+    .next = NULL
+};
+cliEntry_t macroDeleteEntry =
+{
+    .commandCallName = "delete",
+    .commandHelpText = "removes the macro <name>",
+    .execFunctionEx = macroDeleteFunction,
+    .next = &macroListEntry
+};
+cliEntry_t macroRunEntry =
+{
+    .commandCallName = "run",
+    .commandHelpText = "runs the macro <name>, the following arguments replace $1..$9",
+    .execFunctionEx = macroRunFunction,
+    .next = &macroDeleteEntry
+};
+cliEntry_t macroDefineEntry =
+{
+    .commandCallName = "define",
+    .commandHelpText = "stores the commands as macro <name>, e.g. macro define st \"net if stats $1 ; ping\"",
+    .execFunctionEx = macroDefineFunction,
+    .next = &macroRunEntry
+};
+cliEntry_t macroCommandEntry =
+{
+    .commandCallName = "macro",
+    .commandHelpText = "command macros, resolved once and run without parsing",
+    .execFunction = NULL,
+    .next = NULL,
+    .subCommandLinkedListRoot = &macroDefineEntry
+};
 #endif
\ No newline at end of file
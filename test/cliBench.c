@@ -0,0 +1,284 @@
+//Latency of the out-of-band priority keys while the cli is busy
+//a helper thread plays the interrupt: it hits a key at a random moment of a running "spin" command
+//checks the round robin scheduler with a second instance first, fails with exit code 1
+//usage: cliBench.elf [runs]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "cliTestCommands.h" //templates, instance and commands
+
+#define BENCH_SPIN_COMMAND      "spin 30\r"
+#define BENCH_MAX_DELAY_US      20000   //the key arrives within the first 20 of the 30 ms
+#define BENCH_COST_ITERATIONS   1000000
+
+static unsigned long long s_outputBytes = 0;
+
+static unsigned int cliPrintCallback(const char * buffer, unsigned int len)
+{
+    s_outputBytes += len;
+    return len;
+}
+
+static unsigned long long monotonicNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+static unsigned int cliTimeCallback(void)
+{
+    return monotonicNanoseconds() / 1000000ull;
+}
+
+static sem_t s_armed;
+static sem_t s_fired;
+static volatile bool s_sendAbort = false;
+static volatile bool s_stop = false;
+static volatile unsigned long long s_firedAt = 0;
+
+//the "interrupt": sleeps a random time once armed, then hits Ctrl-C (or nothing, for the baseline)
+static void * interruptThread(void * argument)
+{
+    unsigned int seed = 1;
+    for (;;)
+    {
+        sem_wait(&s_armed);
+        if(s_stop)
+        {
+            break;
+        }
+
+        unsigned int delay = 1000 + rand_r(&seed) % (BENCH_MAX_DELAY_US - 1000);
+        struct timespec pause = {.tv_sec = 0, .tv_nsec = delay * 1000l};
+        nanosleep(&pause, NULL);
+
+        s_firedAt = monotonicNanoseconds();
+        if(s_sendAbort)
+        {
+            cli_priorityInput(&s_cliInstance, '\x03');
+        }
+        sem_post(&s_fired);
+    }
+    return NULL;
+}
+
+//second instance on the same command tree, served together with s_cliInstance by the scheduler
+static char s_secondInputBuffer[128];
+static cliInstance_t s_secondInstance =
+{
+    .commandLinkedListRoot = &rootHelpEntry,
+    .inputBuffer = s_secondInputBuffer,
+    .inputBufferMaxSize = sizeof(s_secondInputBuffer),
+    .promptMessage = "\n\r$> ",
+    .printFunction = cliPrintCallback,
+    .timeFunction = cliTimeCallback
+};
+
+static cliSchedulerSlot_t s_schedulerSlots[] =
+{
+    {.instance = &s_cliInstance},
+    {.instance = &s_secondInstance}
+};
+static cliScheduler_t s_scheduler =
+{
+    .slots = s_schedulerSlots,
+    .numSlots = sizeof(s_schedulerSlots) / sizeof(s_schedulerSlots[0]),
+    .timeFunction = cliTimeCallback
+};
+
+//"order" logs which instance ran it: A (s_cliInstance) or B (s_secondInstance)
+static char s_order[32];
+static unsigned int s_orderLength = 0;
+static int orderCommand(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(s_orderLength < sizeof(s_order) - 1)
+    {
+        s_order[s_orderLength++] = (instance == &s_cliInstance ? 'A' : 'B');
+        s_order[s_orderLength] = '\0';
+    }
+    return CLI_STATUS_SUCCESS;
+}
+static cliEntry_t s_orderEntry =
+{
+    .commandCallName = "order",
+    .commandHelpText = "logs the instance running it",
+    .execFunctionEx = orderCommand
+};
+
+static unsigned int s_schedulerFailures = 0;
+static void expect(const char * check, bool passed)
+{
+    printf("%-48s %s\n", check, (passed ? "ok" : "FAILED"));
+    s_schedulerFailures += !passed;
+}
+
+//fresh budgets, metrics and lines for the next scenario
+static void schedulerSetup(const char * lineA, const char * lineB, unsigned int commandBudget, unsigned int timeBudget, unsigned int slotBudgetA)
+{
+    s_scheduler.commandBudget = commandBudget;
+    s_scheduler.timeBudget = timeBudget;
+    s_scheduler.nextSlot = 0;
+    for (unsigned int i = 0; i < s_scheduler.numSlots; i++)
+    {
+        cliSchedulerSlot_t * slot = &s_schedulerSlots[i];
+        slot->commandBudget = 0;
+        slot->executedCommands = 0;
+        slot->deferredTicks = 0;
+        slot->maxPendingCommands = 0;
+    }
+    s_schedulerSlots[0].commandBudget = slotBudgetA;
+    s_orderLength = 0;
+    s_order[0] = '\0';
+
+    cli_inputChars(&s_cliInstance, lineA, strlen(lineA));
+    cli_inputChars(&s_secondInstance, lineB, strlen(lineB));
+}
+
+static void checkScheduler(void)
+{
+    cli_addCommand(&s_cliInstance, &s_orderEntry);
+
+    //both lines interleaved, one command per instance and turn
+    schedulerSetup("order ; order ; order\r", "order ; order\r", 0, 0, 0);
+    expect("queue depth before the tick", (cli_pendingCommands(&s_cliInstance) == 3) && (cli_pendingCommands(&s_secondInstance) == 2));
+    unsigned int executed = cli_schedulerTick(&s_scheduler);
+    expect("round robin order ABABA", (executed == 5) && (strcmp(s_order, "ABABA") == 0));
+    expect("metrics: executed 3/2, nothing left", (s_schedulerSlots[0].executedCommands == 3) && (s_schedulerSlots[1].executedCommands == 2) &&
+        (s_scheduler.readySet == 0) && (s_schedulerSlots[0].pendingCommands == 0) && (s_schedulerSlots[0].deferredTicks == 0));
+
+    //global budget of 3 commands per tick, the next tick continues behind the last served instance
+    schedulerSetup("order ; order ; order\r", "order ; order\r", 3, 0, 0);
+    executed = cli_schedulerTick(&s_scheduler);
+    expect("command budget: ABA, 1/1 left", (executed == 3) && (strcmp(s_order, "ABA") == 0) && (s_scheduler.readySet == 3) &&
+        (s_schedulerSlots[0].pendingCommands == 1) && (s_schedulerSlots[1].pendingCommands == 1));
+    expect("command budget: both deferred once", (s_schedulerSlots[0].deferredTicks == 1) && (s_schedulerSlots[1].deferredTicks == 1));
+    executed = cli_schedulerTick(&s_scheduler);
+    expect("command budget: next tick BA", (executed == 2) && (strcmp(s_order, "ABABA") == 0) && (s_scheduler.readySet == 0));
+
+    //own budget of instance A, B is not held up by it
+    schedulerSetup("order ; order ; order\r", "order\r", 0, 0, 1);
+    executed = cli_schedulerTick(&s_scheduler);
+    expect("slot budget: one command of A per tick", (executed == 2) && (strcmp(s_order, "AB") == 0) && (s_scheduler.readySet == 1));
+    cli_schedulerTick(&s_scheduler);
+    cli_schedulerTick(&s_scheduler);
+    expect("slot budget: A done after 3 ticks", (strcmp(s_order, "ABAA") == 0) && (s_scheduler.readySet == 0) &&
+        (s_schedulerSlots[0].deferredTicks == 2) && (s_schedulerSlots[0].maxPendingCommands == 2));
+
+    //10 ms per tick, checked between commands: the 4 ms spins stop after the third one
+    schedulerSetup("spin 4 ; spin 4 ; spin 4 ; spin 4 ; spin 4\r", "", 0, 10, 0);
+    executed = cli_schedulerTick(&s_scheduler);
+    expect("time budget: 3 of 5 spins", (executed == 3) && (s_schedulerSlots[0].pendingCommands == 2));
+    while(cli_schedulerTick(&s_scheduler));
+    expect("time budget: rest on the next tick", (s_schedulerSlots[0].executedCommands == 5) && (s_scheduler.readySet == 0));
+
+    //Ctrl-C on an instance which is not ready: the typed line is gone and the prompt is out within the same tick
+    schedulerSetup("orde", "", 0, 0, 0);
+    cli_priorityInput(&s_cliInstance, '\x03');
+    unsigned long long outputBytes = s_outputBytes;
+    cli_schedulerTick(&s_scheduler);
+    expect("discard on an idle instance", (s_cliInstance.inputBufferFilledSize == 0) && !s_cliInstance.actionPending &&
+        (s_outputBytes - outputBytes == strlen(s_cliInstance.promptMessage)));
+
+    cli_removeCommand(&s_cliInstance, &s_orderEntry);
+    printf("\n");
+}
+
+static int compareLatencies(const void * a, const void * b)
+{
+    unsigned long long latencyA = *(const unsigned long long *) a;
+    unsigned long long latencyB = *(const unsigned long long *) b;
+    return (latencyA > latencyB) - (latencyA < latencyB);
+}
+
+//runs the spin command, returns the ns from the key until cli_tick() was done with the line
+static void measure(bool sendAbort, unsigned long long * latencies, unsigned int runs)
+{
+    s_sendAbort = sendAbort;
+    for (unsigned int i = 0; i < runs; i++)
+    {
+        cli_inputChars(&s_cliInstance, BENCH_SPIN_COMMAND, strlen(BENCH_SPIN_COMMAND));
+        sem_post(&s_armed);
+        cli_tick(&s_cliInstance);
+        unsigned long long done = monotonicNanoseconds();
+        sem_wait(&s_fired);
+        latencies[i] = done - s_firedAt;
+    }
+}
+
+static void printLatencies(const char * name, unsigned long long * latencies, unsigned int runs)
+{
+    #define PERCENTILE_US(p) (latencies[((runs - 1) * (p)) / 100] / 1000.0)
+    qsort(latencies, runs, sizeof(unsigned long long), compareLatencies);
+    printf("%-24s %8u %10.1f %10.1f %10.1f %10.1f\n", name, runs,
+        PERCENTILE_US(50), PERCENTILE_US(90), PERCENTILE_US(99), PERCENTILE_US(100));
+    #undef PERCENTILE_US
+}
+
+int main(int argc, char const *argv[])
+{
+    unsigned int runs = (argc == 2 ? strtoul(argv[1], NULL, 10) : 200);
+    if(runs == 0)
+    {
+        fprintf(stderr, "usage: %s [runs]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long long * latencies = malloc(runs * sizeof(unsigned long long));
+    if(latencies == NULL)
+    {
+        perror("malloc");
+        return 1;
+    }
+
+    cliTestAddCommands();
+    cli_clear(&s_cliInstance);
+    cli_tick(&s_cliInstance);
+
+    checkScheduler();
+    if(s_schedulerFailures)
+    {
+        free(latencies);
+        return 1;
+    }
+
+    sem_init(&s_armed, 0, 0);
+    sem_init(&s_fired, 0, 0);
+    pthread_t thread;
+    pthread_create(&thread, NULL, interruptThread, NULL);
+
+    //from the key until the cli takes a new line
+    printf("%-24s %8s %10s %10s %10s %10s\n", "key while busy", "count", "p50 us", "p90 us", "p99 us", "max us");
+    measure(true, latencies, runs);
+    printLatencies("Ctrl-C (priority)", latencies, runs);
+    measure(false, latencies, runs);
+    printLatencies("line input (waits)", latencies, runs);
+
+    s_stop = true;
+    sem_post(&s_armed);
+    pthread_join(thread, NULL);
+
+    //cost of the priority check in the input path
+    unsigned long long start = monotonicNanoseconds();
+    for (unsigned int i = 0; i < BENCH_COST_ITERATIONS; i++)
+    {
+        cli_priorityInput(&s_cliInstance, 'a' + (i & 0x0F));
+    }
+    unsigned long long miss = monotonicNanoseconds() - start;
+
+    start = monotonicNanoseconds();
+    for (unsigned int i = 0; i < BENCH_COST_ITERATIONS; i++)
+    {
+        cli_priorityInput(&s_cliInstance, '\x03');
+    }
+    unsigned long long hit = monotonicNanoseconds() - start;
+    cli_tick(&s_cliInstance);
+
+    printf("\npriority check per key: %.1f ns other input, %.1f ns Ctrl-C\n",
+        (double) miss / BENCH_COST_ITERATIONS, (double) hit / BENCH_COST_ITERATIONS);
+
+    free(latencies);
+    return 0;
+}
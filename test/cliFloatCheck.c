@@ -0,0 +1,215 @@
+//Checks the float arguments against the C library
+//cli_getFloat() has to match strtof() bit for bit: random, halfway and long inputs plus a list of edge cases
+//cli_putFloat() has to round-trip through strtof() with no more digits than the shortest "%.*e" that does
+//usage: cliFloatCheck.elf [iterations]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+/*****************************TEMPLATE INCLUDE**************************************/
+//Dependencies
+#define ASCII_PRINTER_STATIC_IMPLEMENTATION
+#define ASCII_PARSER_STATIC_IMPLEMENTATION
+#include "asciiParser_t.h" //Implementation
+#include "asciiPrinter_t.h" //Implementation
+
+#define CLI_ENABLE_FLOAT_ARGUMENTS
+#define CLI_STATIC_IMPLEMENTATION
+#include "cli_t.h" //Implementation
+/***********************************************************************************/
+
+#define CHECK_MAX_REPORTS   20
+
+static const char * s_edgeCases[] =
+{
+    "1.5", "-0.0", "0.1", "+3.e2", ".5e1", "1.e0", "2.5e-3", "1e10", "9.999999e9",
+    "3.4028235e38", "3.4028236e38", "3.40282357e38", "1e39",                //FLT_MAX and overflow
+    "1.17549435e-38", "4.7019774e-38", "1.4e-45", "1e-45", "7.1e-46", "7e-46", //normal/subnormal limits and underflow
+    "16777217.0", "16777219.0", "8388608.5", "8388609.5",                   //ties to even
+    "1.000000059604644775390625",                                           //exact halfway between 1 and its successor
+    "1.00000005960464477539062500001",
+    "1.0000000596046447753906249999999999",
+    "123456789012345678901234567890e-20",
+    "0.000000000000000000000000000000000000000000001401298464324817070923729583289916131280",
+};
+
+static char s_output[64];
+static unsigned int s_outputLength = 0;
+static unsigned int s_failures = 0;
+
+static unsigned int printCallback(const char * buffer, unsigned int len)
+{
+    if(s_outputLength + len < sizeof(s_output))
+    {
+        memcpy(&s_output[s_outputLength], buffer, len);
+        s_outputLength += len;
+        s_output[s_outputLength] = '\0';
+    }
+    return len;
+}
+
+//xorshift64, the runs are reproducible
+static uint64_t s_randomState = 88172645463325252ull;
+static uint64_t randomNumber(void)
+{
+    s_randomState ^= s_randomState << 13;
+    s_randomState ^= s_randomState >> 7;
+    s_randomState ^= s_randomState << 17;
+    return s_randomState;
+}
+
+static uint32_t floatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void reportFailure(const char * format, const char * input, uint32_t expected, uint32_t result)
+{
+    if(s_failures++ < CHECK_MAX_REPORTS)
+    {
+        printf(format, input, expected, result);
+    }
+}
+
+static void checkParse(const char * input)
+{
+    float expected = strtof(input, NULL);
+    float result = cli_getFloat(input);
+    if( (floatBits(expected) != floatBits(result)) && !(isnan(expected) && isnan(result)) )
+    {
+        reportFailure("parse \"%s\": strtof %08x, cli_getFloat %08x\n", input, floatBits(expected), floatBits(result));
+    }
+}
+
+//significant digits of a cli_putFloat() output, leading and trailing zeros don't count
+static unsigned int significantDigits(const char * text)
+{
+    int first = -1;
+    int last = -1;
+    int count = 0;
+    for (const char * c = text; *c && (*c != 'e'); c++)
+    {
+        if( (*c >= '0') && (*c <= '9') )
+        {
+            if( (*c != '0') && (first < 0) )
+            {
+                first = count;
+            }
+            if(*c != '0')
+            {
+                last = count;
+            }
+            count++;
+        }
+    }
+    return (first < 0 ? 1 : last - first + 1);
+}
+
+static unsigned int shortestDigits(float value)
+{
+    char text[32];
+    for (int precision = 1; precision < 9; precision++)
+    {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, value);
+        if(strtof(text, NULL) == value)
+        {
+            return precision;
+        }
+    }
+    return 9;
+}
+
+static void checkPrint(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    if(isnan(value))
+    {
+        return;
+    }
+
+    s_outputLength = 0;
+    cli_putFloat(printCallback, value);
+
+    uint32_t parsed = floatBits(strtof(s_output, NULL));
+    if(parsed != bits)
+    {
+        reportFailure("print %s: %08x reads back as %08x\n", s_output, bits, parsed);
+    }
+    else if( isfinite(value) && (value != 0.0f) && (significantDigits(s_output) > shortestDigits(value)) )
+    {
+        reportFailure("print %s: %08x has %u digits more than the shortest\n", s_output, bits,
+            significantDigits(s_output) - shortestDigits(value));
+    }
+}
+
+int main(int argc, char const *argv[])
+{
+    unsigned int iterations = (argc == 2 ? strtoul(argv[1], NULL, 10) : 1000000);
+    if(iterations == 0)
+    {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long long parsed = 0;
+    unsigned long long printed = 0;
+    char input[96];
+
+    //parser
+    for (unsigned int i = 0; i < sizeof(s_edgeCases) / sizeof(s_edgeCases[0]); i++)
+    {
+        checkParse(s_edgeCases[i]);
+        parsed++;
+    }
+
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+        uint32_t bits = randomNumber();
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if(!isfinite(value))
+        {
+            continue;
+        }
+
+        //random float, printed with 1..25 digits
+        snprintf(input, sizeof(input), "%.*e", (int) (randomNumber() % 25), value);
+        checkParse(input);
+
+        //halfway to the next float, the hardest case for the rounding
+        double halfway = ((double) value + (double) nextafterf(value, INFINITY)) / 2;
+        snprintf(input, sizeof(input), "%.17e", halfway);
+        checkParse(input);
+        snprintf(input, sizeof(input), "%.40e", halfway);
+        checkParse(input);
+
+        //more significant digits than a 64 bit mantissa holds
+        snprintf(input, sizeof(input), "%llu.%llue%d",
+            (unsigned long long) (randomNumber() % 100000000000ull),
+            (unsigned long long) (randomNumber() % 1000000000000ull),
+            (int) (randomNumber() % 90) - 50);
+        checkParse(input);
+        parsed += 4;
+    }
+
+    //printer: a random sweep of all finite bit patterns and the subnormal, normal and FLT_MAX borders
+    for (uint64_t bits = 0; bits < 0x7F800000ull; bits += (randomNumber() % 4096) + 1)
+    {
+        checkPrint(bits);
+        printed++;
+    }
+    for (uint32_t offset = 0; offset < 100000; offset++)
+    {
+        checkPrint(offset);
+        checkPrint(0x00800000 - 50000 + offset);
+        checkPrint(0x7F7FFFFF - offset);
+        printed += 3;
+    }
+
+    printf("%llu parsed, %llu printed, %u failures\n", parsed, printed, s_failures);
+    return (s_failures ? 1 : 0);
+}
@@ -0,0 +1,268 @@
+//Replays a session recorded with "cliTest.elf -r session.clr" against the same command set
+//verifies that the output is reproduced and reports the latency of the executed lines
+//usage: cliReplay.elf [-realtime] session.clr
+//flat-out by default, -realtime keeps the recorded pauses between the inputs
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "cliTestCommands.h" //templates, instance and commands
+
+static char * s_output = NULL;
+static size_t s_outputLength = 0;
+static size_t s_outputSize = 0;
+static unsigned int s_sessionTime = 0; //ms since the start of the recording
+
+static void appendBuffer(char ** buffer, size_t * length, size_t * size, const char * data, size_t len)
+{
+    if(*length + len > *size)
+    {
+        *size = (*length + len) * 2;
+        *buffer = realloc(*buffer, *size);
+        if(*buffer == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    memcpy(&(*buffer)[*length], data, len);
+    *length += len;
+}
+
+static unsigned int cliPrintCallback(const char * buffer, unsigned int len)
+{
+    appendBuffer(&s_output, &s_outputLength, &s_outputSize, buffer, len);
+    return len;
+}
+
+//the replay runs on the recorded clock, time dependent commands (cache TTL) behave as recorded
+static unsigned int cliTimeCallback(void)
+{
+    return s_sessionTime;
+}
+
+static unsigned long long monotonicNanoseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long) now.tv_sec * 1000000000ull + now.tv_nsec;
+}
+
+static bool readVarint(const unsigned char * data, size_t size, size_t * offset, unsigned int * value)
+{
+    *value = 0;
+    for (unsigned int shift = 0; (*offset < size) && (shift < 35); shift += 7)
+    {
+        unsigned char byte = data[(*offset)++];
+        *value |= (unsigned int) (byte & 0x7F) << shift;
+        if(!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+typedef struct latencySample_s
+{
+    char command[16];
+    unsigned long long nanoseconds;
+}latencySample_t;
+
+static int compareSamples(const void * a, const void * b)
+{
+    const latencySample_t * sampleA = a;
+    const latencySample_t * sampleB = b;
+    int compare = strcmp(sampleA->command, sampleB->command);
+    if(compare == 0)
+    {
+        compare = (sampleA->nanoseconds > sampleB->nanoseconds) - (sampleA->nanoseconds < sampleB->nanoseconds);
+    }
+    return compare;
+}
+
+//samples must be sorted by latency
+static void printPercentiles(const char * name, const latencySample_t * samples, size_t numSamples)
+{
+    #define PERCENTILE_US(p) (samples[((numSamples - 1) * (p)) / 100].nanoseconds / 1000.0)
+    printf("%-16s %8zu %10.1f %10.1f %10.1f %10.1f\n", name, numSamples,
+        PERCENTILE_US(50), PERCENTILE_US(90), PERCENTILE_US(99), PERCENTILE_US(100));
+    #undef PERCENTILE_US
+}
+
+int main(int argc, char const *argv[])
+{
+    bool realtime = (argc == 3) && (strcmp(argv[1], "-realtime") == 0);
+    if( (argc != 2) && !realtime )
+    {
+        fprintf(stderr, "usage: %s [-realtime] session.clr\n", argv[0]);
+        return 1;
+    }
+
+    //load the whole recording
+    FILE * file = fopen(argv[argc - 1], "rb");
+    if(file == NULL)
+    {
+        perror(argv[argc - 1]);
+        return 1;
+    }
+    char * recording = NULL;
+    size_t recordingSize = 0;
+    size_t recordingBufferSize = 0;
+    char chunk[4096];
+    size_t chunkLength;
+    while((chunkLength = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        appendBuffer(&recording, &recordingSize, &recordingBufferSize, chunk, chunkLength);
+    }
+    fclose(file);
+
+    if( (recordingSize < CLI_RECORD_MAGIC_SIZE) || memcmp(recording, CLI_RECORD_MAGIC, CLI_RECORD_MAGIC_SIZE) )
+    {
+        fprintf(stderr, "%s: no session recording\n", argv[argc - 1]);
+        return 1;
+    }
+
+    char * expected = NULL;
+    size_t expectedLength = 0;
+    size_t expectedSize = 0;
+    latencySample_t * samples = NULL;
+    size_t numSamples = 0;
+    size_t samplesSize = 0;
+    unsigned long long replayStart = monotonicNanoseconds();
+
+    //same start as the recorder: prompt first
+    cliTestAddCommands();
+    cli_clear(&s_cliInstance);
+    cli_tick(&s_cliInstance);
+
+    const unsigned char * bytes = (const unsigned char *) recording;
+    size_t offset = CLI_RECORD_MAGIC_SIZE;
+    while(offset < recordingSize)
+    {
+        char direction = recording[offset++];
+        unsigned int delta;
+        unsigned int length;
+        if( !readVarint(bytes, recordingSize, &offset, &delta) ||
+            !readVarint(bytes, recordingSize, &offset, &length) ||
+            (length > recordingSize - offset) )
+        {
+            fprintf(stderr, "truncated record at offset %zu\n", offset);
+            return 1;
+        }
+        const char * data = &recording[offset];
+        offset += length;
+        s_sessionTime += delta;
+
+        //timer driven output (watch) is produced at the time it was recorded
+        if(s_cliInstance.watchCommand)
+        {
+            cli_tick(&s_cliInstance);
+        }
+
+        if(direction == CLI_RECORD_OUTPUT)
+        {
+            appendBuffer(&expected, &expectedLength, &expectedSize, data, length);
+            continue;
+        }
+
+        if(realtime)
+        {
+            unsigned long long due = replayStart + (unsigned long long) s_sessionTime * 1000000ull;
+            unsigned long long now = monotonicNanoseconds();
+            if(due > now)
+            {
+                struct timespec pause = {.tv_sec = (due - now) / 1000000000ull, .tv_nsec = (due - now) % 1000000000ull};
+                nanosleep(&pause, NULL);
+            }
+        }
+
+        for (unsigned int i = 0; i < length; i++)
+        {
+            cli_inputChar(&s_cliInstance, data[i]);
+            if(s_cliInstance.discardRequested)
+            {
+                cli_tick(&s_cliInstance); //abort key while idle: the typed line is dropped for a fresh prompt
+                continue;
+            }
+            if(!s_cliInstance.actionPending)
+            {
+                continue;
+            }
+
+            //completed line, its command name labels the sample
+            latencySample_t sample = {.command = ""};
+            unsigned int nameLength = 0;
+            while( (nameLength < s_cliInstance.inputBufferFilledSize) && (nameLength < sizeof(sample.command) - 1) &&
+                   (s_cliInstance.inputBuffer[nameLength] != ' ') )
+            {
+                sample.command[nameLength] = s_cliInstance.inputBuffer[nameLength];
+                nameLength++;
+            }
+
+            unsigned long long start = monotonicNanoseconds();
+            cli_tick(&s_cliInstance);
+            sample.nanoseconds = monotonicNanoseconds() - start;
+
+            if(nameLength)
+            {
+                if(numSamples == samplesSize)
+                {
+                    samplesSize = (samplesSize ? samplesSize * 2 : 256);
+                    samples = realloc(samples, samplesSize * sizeof(latencySample_t));
+                    if(samples == NULL)
+                    {
+                        perror("realloc");
+                        return 1;
+                    }
+                }
+                samples[numSamples++] = sample;
+            }
+        }
+    }
+
+    //output check
+    int result = 0;
+    if( (expectedLength == s_outputLength) && (memcmp(expected, s_output, expectedLength) == 0) )
+    {
+        printf("output matches (%zu bytes)\n", expectedLength);
+    }
+    else
+    {
+        size_t mismatch = 0;
+        while( (mismatch < expectedLength) && (mismatch < s_outputLength) && (expected[mismatch] == s_output[mismatch]) )
+        {
+            mismatch++;
+        }
+        printf("output differs at byte %zu (recorded %zu bytes, replayed %zu bytes)\n", mismatch, expectedLength, s_outputLength);
+        result = 2;
+    }
+
+    //latency per command and over all, in us
+    if(numSamples)
+    {
+        printf("%-16s %8s %10s %10s %10s %10s\n", "command", "count", "p50 us", "p90 us", "p99 us", "max us");
+        qsort(samples, numSamples, sizeof(latencySample_t), compareSamples);
+        size_t first = 0;
+        for (size_t i = 1; i <= numSamples; i++)
+        {
+            if( (i == numSamples) || strcmp(samples[i].command, samples[first].command) )
+            {
+                printPercentiles(samples[first].command, &samples[first], i - first);
+                first = i;
+            }
+        }
+
+        for (size_t i = 0; i < numSamples; i++)
+        {
+            samples[i].command[0] = '\0';
+        }
+        qsort(samples, numSamples, sizeof(latencySample_t), compareSamples);
+        printPercentiles("(all)", samples, numSamples);
+    }
+
+    free(samples);
+    free(expected);
+    free(recording);
+    free(s_output);
+    return result;
+}
@@ -1,252 +1,102 @@
 #include <stdio.h>
 #include <time.h>
-/*****************************TEMPLATE INCLUDE**************************************/
-//Dependencies
-#define ASCII_PRINTER_STATIC_IMPLEMENTATION
-#define ASCII_PARSER_STATIC_IMPLEMENTATION
-#include "asciiParser_t.h" //Implementation
-#include "asciiPrinter_t.h" //Implementation
+#include <signal.h>
+#include "cliTestCommands.h" //templates, instance and commands
 
-#define CLI_IMPLEMENT_HELP_FUNC_COMMAND
-#define CLI_STATIC_IMPLEMENTATION
-//following just for testing
 #define CLI_ONLY_PROTOTYPE_DECLARATION
-#include "cli_t.h" //Prototype
+#include "cliPosix_t.h" //Prototype
 #undef CLI_ONLY_PROTOTYPE_DECLARATION
-#include "cli_t.h" //Implementation
-/***********************************************************************************/
+#include "cliPosix_t.h" //Implementation
 
 static unsigned int cliPrintCallback(const char * buffer, unsigned int len)
 {
-    for (unsigned int i = 0; i < len; i++)
-    {
-        putchar(buffer[i]);
-    }
-    return 0;
+    //stdout is non-blocking when it shares the terminal with stdin, the rest stays in the output queue
+    ssize_t written = write(STDOUT_FILENO, buffer, len);
+    return (written > 0 ? written : 0);
 }
 
-char cliInputBuffer[128];
-static cliInstance_t s_cliInstance =
+static unsigned int monotonicMilliseconds(void)
 {
-    .commandLinkedListRoot = &rootHelpEntry,
-    .inputBuffer = cliInputBuffer,
-    .inputBufferMaxSize = sizeof(cliInputBuffer),
-    .inputBufferFilledSize = 0,
-    .localEcho = false,
-    .actionPending = false,
-    .promptMessage = "\n\r$> ",
-    .printFunction = cliPrintCallback
-};
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
 
-static void printHelloWorld(int argc, char const *argv[], cliPrint_func outputFunc)
+//ms since the start, like the clock of a replayed session
+static unsigned int s_startTime = 0;
+static unsigned int cliTimeCallback(void)
 {
-    outputFunc("hello world!\n", 13);
+    return monotonicMilliseconds() - s_startTime;
 }
-static void ping(int argc, char const *argv[], cliPrint_func outputFunc)
+
+//"cliTest.elf -r session.clr" records the session for cliReplay.elf
+static FILE * s_recordFile = NULL;
+static unsigned int cliRecordCallback(const char * buffer, unsigned int len)
 {
-    outputFunc("pong!\n", 6);
+    return fwrite(buffer, 1, len, s_recordFile);
 }
-static void argPrinter(int argc, char const *argv[], cliPrint_func outputFunc)
-{
-    for (unsigned int i = 0; i < argc; i++)
-    {
-        const char argPrefix[] = "Argument ";
-        outputFunc(argPrefix,sizeof(argPrefix));
-        outputFunc("[",1);
-        char index = i + 48;
-        outputFunc(&index,1);
-        outputFunc("]: ",3);
-
-        outputFunc(argv[i],strlen(argv[i]));
-
-        outputFunc(" (",2);
-        switch (cli_classifyArgumentType(argv[i]))
-        {
-        case CLI_ARGUMENT_BINARY_LITERAL:
-            {
-                const char typeMsg[] = "Binary Literal";
-                outputFunc(typeMsg, sizeof(typeMsg));
-            }break;
 
-        case CLI_ARGUMENT_DEC_INT:
-            {
-                const char typeMsg[] = "Signed Decimal Integer";
-                outputFunc(typeMsg, sizeof(typeMsg));
-            }break;
-        
-        case CLI_ARGUMENT_DEC_UINT:
-            {
-                const char typeMsg[] = "Unsigned Decimal Integer";
-                outputFunc(typeMsg, sizeof(typeMsg));
-            }break;
-
-        case CLI_ARGUMENT_HEX_LITERAL:
-            {
-                const char typeMsg[] = "Hexadecimal Literal";
-                outputFunc(typeMsg, sizeof(typeMsg));
-            }break;
-        
-        case CLI_ARGUMENT_BYTE_ARRAY:
-            {
-                const char typeMsg[] = "Hexadecimal Byte Array";
-                outputFunc(typeMsg, sizeof(typeMsg));
-            }break;
-
-        case CLI_ARGUMENT_STRING:
-            {
-                const char typeMsg[] = "String";
-                outputFunc(typeMsg, sizeof(typeMsg));
-            }break;
-        default:
-            break;
-        }        
-        outputFunc(")",1);
-        outputFunc("\n\r",2);
-    }
-    
+static cliPosixDriver_t s_cliDriver =
+{
+    .instance = &s_cliInstance,
+    .inputFd = STDIN_FILENO,
+    .outputFd = STDOUT_FILENO
+};
+static volatile sig_atomic_t s_terminate = 0;
+static void onTerminate(int signal)
+{
+    s_terminate = 1;
+    cli_posixWakeup(&s_cliDriver);
 }
 
-static void printDec(int argc, char const *argv[], cliPrint_func outputFunc)
+//Ctrl-C on the terminal: aborts a running command like an interrupt would, ends the demo otherwise
+static void onInterrupt(int signal)
 {
-    if(!argc)
-        return;
-
-    cliArgumentType_t type = cli_classifyArgumentType(argv[0]);
-    switch (type)
+    if(!s_cliInstance.dispatchStarted || !cli_priorityInput(&s_cliInstance, '\x03'))
     {
-        case CLI_ARGUMENT_DEC_INT:
-        case CLI_ARGUMENT_DEC_UINT:
-        {
-            unsigned int temp = cli_getSignedDecimal(argv[0]);
-            cli_putUnsignedDecimal(outputFunc, temp);
-        }break;
-
-        case CLI_ARGUMENT_HEX_LITERAL:
-        {
-            unsigned int temp = cli_getUnsignedHex(argv[0]);
-            cli_putUnsignedDecimal(outputFunc, temp);
-        }break;
-
-        default:
-            break;
+        onTerminate(signal);
     }
 }
 
-static void printHex(int argc, char const *argv[], cliPrint_func outputFunc)
+int main(int argc, char const *argv[])
 {
-    if(!argc)
-        return;
+    s_startTime = monotonicMilliseconds();
+    cliTestAddCommands();
 
-    cliArgumentType_t type = cli_classifyArgumentType(argv[0]);
-    switch (type)
+    if( (argc == 3) && (strcmp(argv[1], "-r") == 0) )
     {
-        case CLI_ARGUMENT_DEC_INT:
-        case CLI_ARGUMENT_DEC_UINT:
-        {
-            unsigned int temp = cli_getSignedDecimal(argv[0]);
-            cli_putUnsignedHex(outputFunc, temp);
-        }break;
-
-        case CLI_ARGUMENT_HEX_LITERAL:
+        s_recordFile = fopen(argv[2], "wb");
+        if(s_recordFile == NULL)
         {
-            unsigned int temp = cli_getUnsignedHex(argv[0]);
-            cli_putUnsignedHex(outputFunc, temp);
-        }break;
-
-        default:
-            break;
+            perror(argv[2]);
+            return 1;
+        }
+        s_startTime = monotonicMilliseconds(); //the replayed clock starts with the recording
+        cli_startRecording(&s_cliInstance, cliRecordCallback);
     }
-}
 
-static void arrayCounter(int argc, char const *argv[], cliPrint_func outputFunc)
-{
-    if(!argc)
-        return;
-
-    cliArgumentType_t type = cli_classifyArgumentType(argv[0]);
-    switch (type)
+    if(cli_posixInit(&s_cliDriver) < 0)
     {
-        case CLI_ARGUMENT_BYTE_ARRAY:
-        {
-            unsigned int temp = cli_getByteArraySize(argv[0]);
-            unsigned char buffer[temp];
-            cli_getByteArrayElements(argv[0], buffer);
-
-            outputFunc("num elements: ", 14);
-            cli_putUnsignedDecimal(outputFunc, temp);
-
-            for (unsigned int i = 0; i < temp; i++)
-            {
-                outputFunc("\r\n [",4);
-                cli_putUnsignedDecimal(outputFunc, i);
-                outputFunc("]: ",3);
-                cli_putByteHex(outputFunc, buffer[i]);
-            }
-            
-        }break;
-
-        default:
-            break;
+        perror("cli_posixInit");
+        return 1;
     }
-}
+    if(cli_posixEnableRawMode(&s_cliDriver) == 0) //fails for pipes, which is fine
+    {
+        s_cliInstance.localEcho = true;
+    }
+    signal(SIGINT, onInterrupt);
+    signal(SIGTERM, onTerminate);
 
-cliEntry_t helloWorldEntry =
-{
-    .commandCallName= "helloworld",
-    .commandHelpText= "prints a simple Hello World",
-    .execFunction = printHelloWorld,
-    .next = NULL
-};
-cliEntry_t pingEntry =
-{
-    .commandCallName= "ping",
-    .commandHelpText= "prints a pong!",
-    .execFunction = ping,
-    .next = NULL
-};
-cliEntry_t argPrinterEntry =
-{
-    .commandCallName= "argprint",
-    .commandHelpText= "prints out all given args",
-    .execFunction = argPrinter,
-    .next = NULL
-};
-cliEntry_t printHexEntry =
-{
-    .commandCallName= "printhex",
-    .commandHelpText= "prints out a given argument as a hexadecimal Value",
-    .execFunction = printHex,
-    .next = NULL
-};
-cliEntry_t printDec2DecEntry =
-{
-    .commandCallName= "printdec",
-    .commandHelpText= "prints out a given decimal argument as a decimal Value",
-    .execFunction = printDec,
-    .next = NULL
-};
-cliEntry_t arrayCounterEntry =
-{
-    .commandCallName= "cntarr",
-    .commandHelpText= "prints out the number of elements in a given Byte Array",
-    .execFunction = arrayCounter,
-    .next = NULL
-};
-int main(int argc, char const *argv[])
-{
-    cli_addCommand(&s_cliInstance, &helloWorldEntry);
-    cli_addCommand(&s_cliInstance, &pingEntry);
-    cli_addCommand(&s_cliInstance, &argPrinterEntry);
-    cli_addCommand(&s_cliInstance, &printHexEntry);
-    cli_addCommand(&s_cliInstance, &printDec2DecEntry);
-    cli_addCommand(&s_cliInstance, &arrayCounterEntry);
     cli_clear(&s_cliInstance);
 
-    while (1)
-    {
-        char c = getchar();
+    //sleeps in poll() until there is input, room for queued output or a wakeup
+    while (!s_terminate && (cli_posixRun(&s_cliDriver, -1) >= 0));
 
-        cli_inputChar(&s_cliInstance, c);
-        cli_tick(&s_cliInstance);
+    cli_posixDeinit(&s_cliDriver);
+    if(s_recordFile)
+    {
+        cli_stopRecording(&s_cliInstance);
+        fclose(s_recordFile);
     }
+    return 0;
 }
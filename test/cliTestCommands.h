@@ -0,0 +1,472 @@
+//Command set and instance shared by the demo (cliTest.c) and the session replay (cliReplay.c)
+//a replayed session only reproduces its output with the very same configuration
+#ifndef _CLI_TEST_COMMANDS_H
+#define _CLI_TEST_COMMANDS_H
+
+#include <string.h>
+#include <time.h>
+/*****************************TEMPLATE INCLUDE**************************************/
+//Dependencies
+#define ASCII_PRINTER_STATIC_IMPLEMENTATION
+#define ASCII_PARSER_STATIC_IMPLEMENTATION
+#include "asciiParser_t.h" //Implementation
+#include "asciiPrinter_t.h" //Implementation
+
+#define CLI_IMPLEMENT_HELP_FUNC_COMMAND
+#define CLI_ENABLE_LINE_EDITOR
+#define CLI_ENABLE_HISTORY
+#define CLI_ENABLE_OUTPUT_QUEUE
+#define CLI_ENABLE_OUTPUT_CACHE
+#define CLI_ENABLE_SCRATCH_ARENA
+#define CLI_ENABLE_FLOAT_ARGUMENTS
+#define CLI_ENABLE_STRUCTURED_OUTPUT
+#define CLI_ENABLE_RECORDING
+#define CLI_ENABLE_WATCH
+#define CLI_IMPLEMENT_WATCH_COMMAND
+#define CLI_ENABLE_MACROS
+#define CLI_IMPLEMENT_MACRO_COMMAND
+#define CLI_ENABLE_PRIORITY_COMMANDS
+#define CLI_ENABLE_SCHEDULER
+#define CLI_STATIC_IMPLEMENTATION
+//following just for testing
+#define CLI_ONLY_PROTOTYPE_DECLARATION
+#include "cli_t.h" //Prototype
+#undef CLI_ONLY_PROTOTYPE_DECLARATION
+#include "cli_t.h" //Implementation
+/***********************************************************************************/
+
+
+//provided by the including program
+static unsigned int cliPrintCallback(const char * buffer, unsigned int len);
+static unsigned int cliTimeCallback(void);
+
+char cliInputBuffer[128];
+cliPrefixNode_t cliPrefixIndex[128];
+char cliHistoryBuffer[512];
+char cliOutputQueue[256];
+cliOutputCacheSlot_t cliOutputCache[4];
+unsigned char cliScratchArena[64];
+char cliWatchBuffer[512];
+unsigned char cliMacroArena[512];
+static void printStatus(cliInstance_t * instance);
+cliPriorityEntry_t cliPriorityCommands[] =
+{
+    {.key = '\x03', .abort = true},             //Ctrl-C
+    {.key = '\x14', .function = printStatus}    //Ctrl-T
+};
+static cliInstance_t s_cliInstance =
+{
+    .commandLinkedListRoot = &rootHelpEntry,
+    .inputBuffer = cliInputBuffer,
+    .inputBufferMaxSize = sizeof(cliInputBuffer),
+    .inputBufferFilledSize = 0,
+    .localEcho = false,
+    .actionPending = false,
+    .promptMessage = "\n\r$> ",
+    .printFunction = cliPrintCallback,
+    .timeFunction = cliTimeCallback,
+    .prefixIndexPool = cliPrefixIndex,
+    .prefixIndexPoolSize = sizeof(cliPrefixIndex) / sizeof(cliPrefixIndex[0]),
+    .historyBuffer = cliHistoryBuffer,
+    .historyBufferSize = sizeof(cliHistoryBuffer),
+    .outputQueueBuffer = cliOutputQueue,
+    .outputQueueSize = sizeof(cliOutputQueue),
+    .outputCacheSlots = cliOutputCache,
+    .outputCacheNumSlots = sizeof(cliOutputCache) / sizeof(cliOutputCache[0]),
+    .scratchArena = cliScratchArena,
+    .scratchArenaSize = sizeof(cliScratchArena),
+    .watchBuffer = cliWatchBuffer,
+    .watchBufferSize = sizeof(cliWatchBuffer),
+    .macroArena = cliMacroArena,
+    .macroArenaSize = sizeof(cliMacroArena),
+    .priorityCommands = cliPriorityCommands,
+    .numPriorityCommands = sizeof(cliPriorityCommands) / sizeof(cliPriorityCommands[0])
+};
+
+//Ctrl-T, answered right away even while a line is pending
+static void printStatus(cliInstance_t * instance)
+{
+    if(instance->actionPending)
+    {
+        cli_print(instance, "\r\n[busy]\r\n", 10);
+        return;
+    }
+
+    //the status lands on the line being typed, which gets redrawn below it
+    cli_print(instance, "\r\n[idle]", 8);
+    cli_print(instance, instance->promptMessage, strlen(instance->promptMessage));
+    cli_print(instance, instance->inputBuffer, instance->inputBufferFilledSize);
+    for (unsigned int i = instance->cursorPosition; i < instance->inputBufferFilledSize; i++)
+    {
+        cli_print(instance, "\b", 1);
+    }
+}
+
+static void printHelloWorld(int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    outputFunc("hello world!\n", 13);
+}
+static void ping(int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    outputFunc("pong!\n", 6);
+}
+static void argPrinter(int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    for (unsigned int i = 0; i < argc; i++)
+    {
+        const char argPrefix[] = "Argument ";
+        outputFunc(argPrefix,sizeof(argPrefix));
+        outputFunc("[",1);
+        char index = i + 48;
+        outputFunc(&index,1);
+        outputFunc("]: ",3);
+
+        outputFunc(argv[i],strlen(argv[i]));
+
+        outputFunc(" (",2);
+        switch (cli_classifyArgumentType(argv[i]))
+        {
+        case CLI_ARGUMENT_BINARY_LITERAL:
+            {
+                const char typeMsg[] = "Binary Literal";
+                outputFunc(typeMsg, sizeof(typeMsg));
+            }break;
+
+        case CLI_ARGUMENT_DEC_INT:
+            {
+                const char typeMsg[] = "Signed Decimal Integer";
+                outputFunc(typeMsg, sizeof(typeMsg));
+            }break;
+        
+        case CLI_ARGUMENT_DEC_UINT:
+            {
+                const char typeMsg[] = "Unsigned Decimal Integer";
+                outputFunc(typeMsg, sizeof(typeMsg));
+            }break;
+
+        case CLI_ARGUMENT_HEX_LITERAL:
+            {
+                const char typeMsg[] = "Hexadecimal Literal";
+                outputFunc(typeMsg, sizeof(typeMsg));
+            }break;
+        
+        case CLI_ARGUMENT_BYTE_ARRAY:
+            {
+                const char typeMsg[] = "Hexadecimal Byte Array";
+                outputFunc(typeMsg, sizeof(typeMsg));
+            }break;
+
+        case CLI_ARGUMENT_FLOAT:
+            {
+                const char typeMsg[] = "Floating Point";
+                outputFunc(typeMsg, sizeof(typeMsg));
+            }break;
+
+        case CLI_ARGUMENT_STRING:
+            {
+                const char typeMsg[] = "String";
+                outputFunc(typeMsg, sizeof(typeMsg));
+            }break;
+        default:
+            break;
+        }        
+        outputFunc(")",1);
+        outputFunc("\n\r",2);
+    }
+    
+}
+
+static int printDec(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(!argc)
+        return CLI_STATUS_FAILURE;
+
+    cliArgumentType_t type = cli_classifyArgumentType(argv[0]);
+    switch (type)
+    {
+        case CLI_ARGUMENT_DEC_INT:
+        case CLI_ARGUMENT_DEC_UINT:
+        {
+            unsigned int temp = cli_getSignedDecimal(argv[0]);
+            cli_putUnsignedDecimal(outputFunc, temp);
+        }break;
+
+        case CLI_ARGUMENT_HEX_LITERAL:
+        {
+            unsigned int temp = cli_getUnsignedHex(argv[0]);
+            cli_putUnsignedDecimal(outputFunc, temp);
+        }break;
+
+        default:
+            return CLI_STATUS_FAILURE;
+    }
+    return CLI_STATUS_SUCCESS;
+}
+
+static void printHex(int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(!argc)
+        return;
+
+    cliArgumentType_t type = cli_classifyArgumentType(argv[0]);
+    switch (type)
+    {
+        case CLI_ARGUMENT_DEC_INT:
+        case CLI_ARGUMENT_DEC_UINT:
+        {
+            unsigned int temp = cli_getSignedDecimal(argv[0]);
+            cli_putUnsignedHex(outputFunc, temp);
+        }break;
+
+        case CLI_ARGUMENT_HEX_LITERAL:
+        {
+            unsigned int temp = cli_getUnsignedHex(argv[0]);
+            cli_putUnsignedHex(outputFunc, temp);
+        }break;
+
+        default:
+            break;
+    }
+}
+
+static int printFloat(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(!argc)
+        return CLI_STATUS_FAILURE;
+
+    for (int i = 0; i < argc; i++)
+    {
+        switch (cli_classifyArgumentType(argv[i]))
+        {
+            case CLI_ARGUMENT_FLOAT:
+            case CLI_ARGUMENT_DEC_INT:
+            case CLI_ARGUMENT_DEC_UINT:
+            {
+                cli_putFloat(outputFunc, cli_getFloat(argv[i]));
+                outputFunc("\n\r", 2);
+            }break;
+
+            default:
+                return CLI_STATUS_FAILURE;
+        }
+    }
+    return CLI_STATUS_SUCCESS;
+}
+
+static int arrayCounter(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(!argc)
+        return CLI_STATUS_FAILURE;
+
+    cliArgumentType_t type = cli_classifyArgumentType(argv[0]);
+    switch (type)
+    {
+        case CLI_ARGUMENT_BYTE_ARRAY:
+        {
+            unsigned int temp = cli_getByteArraySize(argv[0]);
+            unsigned char * buffer = cli_scratchAlloc(instance, temp);
+            if(buffer == NULL)
+            {
+                outputFunc("out of memory", 13);
+                return CLI_STATUS_FAILURE;
+            }
+            cli_getByteArrayElements(argv[0], buffer);
+
+            cli_emitObjectBegin(instance);
+            cli_emitKey(instance, "numElements");
+            cli_emitUnsigned(instance, temp);
+            cli_emitKey(instance, "elements");
+            cli_emitByteArray(instance, buffer, temp);
+            cli_emitObjectEnd(instance);
+        }break;
+
+        default:
+            return CLI_STATUS_FAILURE;
+    }
+    return CLI_STATUS_SUCCESS;
+}
+
+static int setOutputFormat(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(argc != 1)
+        return CLI_STATUS_FAILURE;
+
+    if(strcmp(argv[0], "text") == 0)
+    {
+        cli_setOutputFormat(instance, CLI_OUTPUT_TEXT);
+    }
+    else if(strcmp(argv[0], "json") == 0)
+    {
+        cli_setOutputFormat(instance, CLI_OUTPUT_JSON);
+    }
+    else if(strcmp(argv[0], "tlv") == 0)
+    {
+        cli_setOutputFormat(instance, CLI_OUTPUT_TLV);
+    }
+    else
+    {
+        return CLI_STATUS_FAILURE;
+    }
+    return CLI_STATUS_SUCCESS;
+}
+
+static void uptime(int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    unsigned int now = cliTimeCallback();
+    outputFunc("up ", 3);
+    cli_putUnsignedDecimal(outputFunc, now / 1000);
+    outputFunc(" s\n\r", 4);
+    outputFunc("ms ", 3);
+    cli_putUnsignedDecimal(outputFunc, now % 1000);
+    outputFunc("\n\r", 2);
+}
+
+//real time even in a replayed session, whose clock stands still while a command runs
+static unsigned int spinMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static int spin(cliInstance_t * instance, int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if( (argc != 1) || (cli_classifyArgumentType(argv[0]) != CLI_ARGUMENT_DEC_UINT) )
+        return CLI_STATUS_FAILURE;
+
+    //keeps the cli busy, Ctrl-C ends it early
+    unsigned int duration = cli_getUnsignedDecimal(argv[0]);
+    unsigned int start = spinMilliseconds();
+    while(spinMilliseconds() - start < duration)
+    {
+        if(cli_abortRequested(instance))
+        {
+            outputFunc("aborted", 7);
+            return CLI_STATUS_FAILURE;
+        }
+    }
+    return CLI_STATUS_SUCCESS;
+}
+
+static void netInterfaceStats(int argc, char const *argv[], cliPrint_func outputFunc)
+{
+    if(!argc)
+        return;
+
+    outputFunc("stats of ", 9);
+    outputFunc(argv[0], strlen(argv[0]));
+    outputFunc(": rx 0 tx 0\n", 12);
+}
+
+cliEntry_t helloWorldEntry =
+{
+    .commandCallName= "helloworld",
+    .commandHelpText= "prints a simple Hello World",
+    .execFunction = printHelloWorld,
+    .next = NULL,
+    .outputCacheTimeToLive = CLI_OUTPUT_CACHE_UNTIL_INVALIDATED
+};
+cliEntry_t pingEntry =
+{
+    .commandCallName= "ping",
+    .commandHelpText= "prints a pong!",
+    .execFunction = ping,
+    .next = NULL
+};
+cliEntry_t argPrinterEntry =
+{
+    .commandCallName= "argprint",
+    .commandHelpText= "prints out all given args",
+    .execFunction = argPrinter,
+    .next = NULL
+};
+cliEntry_t printHexEntry =
+{
+    .commandCallName= "printhex",
+    .commandHelpText= "prints out a given argument as a hexadecimal Value",
+    .execFunction = printHex,
+    .next = NULL
+};
+cliEntry_t printDec2DecEntry =
+{
+    .commandCallName= "printdec",
+    .commandHelpText= "prints out a given decimal argument as a decimal Value, fails on anything else",
+    .execFunctionEx = printDec,
+    .next = NULL
+};
+cliEntry_t printFloatEntry =
+{
+    .commandCallName= "printfloat",
+    .commandHelpText= "prints out the given decimal arguments as the nearest float in shortest form",
+    .execFunctionEx = printFloat,
+    .next = NULL
+};
+cliEntry_t arrayCounterEntry =
+{
+    .commandCallName= "cntarr",
+    .commandHelpText= "prints out the number of elements in a given Byte Array",
+    .execFunctionEx = arrayCounter,
+    .next = NULL
+};
+cliEntry_t formatEntry =
+{
+    .commandCallName= "format",
+    .commandHelpText= "selects the rendering of structured output: text, json or tlv",
+    .execFunctionEx = setOutputFormat,
+    .next = NULL
+};
+cliEntry_t uptimeEntry =
+{
+    .commandCallName= "uptime",
+    .commandHelpText= "prints the time since the start, try: watch 1000 uptime",
+    .execFunction = uptime,
+    .next = NULL
+};
+cliEntry_t spinEntry =
+{
+    .commandCallName= "spin",
+    .commandHelpText= "keeps the cli busy for the given ms, Ctrl-C aborts it",
+    .execFunctionEx = spin,
+    .next = NULL
+};
+cliEntry_t netEntry =
+{
+    .commandCallName= "net",
+    .commandHelpText= "network commands",
+    .execFunction = NULL,
+    .next = NULL
+};
+cliEntry_t netInterfaceEntry =
+{
+    .commandCallName= "if",
+    .commandHelpText= "network interface commands",
+    .execFunction = NULL,
+    .next = NULL
+};
+cliEntry_t netInterfaceStatsEntry =
+{
+    .commandCallName= "stats",
+    .commandHelpText= "prints the counters of a given interface, e.g. net if stats eth0",
+    .execFunction = netInterfaceStats,
+    .next = NULL
+};
+static void cliTestAddCommands(void)
+{
+    cli_addCommand(&s_cliInstance, &helloWorldEntry);
+    cli_addCommand(&s_cliInstance, &pingEntry);
+    cli_addCommand(&s_cliInstance, &argPrinterEntry);
+    cli_addCommand(&s_cliInstance, &printHexEntry);
+    cli_addCommand(&s_cliInstance, &printDec2DecEntry);
+    cli_addCommand(&s_cliInstance, &printFloatEntry);
+    cli_addCommand(&s_cliInstance, &arrayCounterEntry);
+    cli_addCommand(&s_cliInstance, &formatEntry);
+    cli_addCommand(&s_cliInstance, &uptimeEntry);
+    cli_addCommand(&s_cliInstance, &watchCommandEntry);
+    cli_addCommand(&s_cliInstance, &macroCommandEntry);
+    cli_addCommand(&s_cliInstance, &spinEntry);
+    cli_addCommand(&s_cliInstance, &netEntry);
+    cli_addSubCommand(&netEntry, &netInterfaceEntry);
+    cli_addSubCommand(&netInterfaceEntry, &netInterfaceStatsEntry);
+}
+
+#endif //_CLI_TEST_COMMANDS_H